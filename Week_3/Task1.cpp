@@ -1,10 +1,37 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <limits>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <charconv>
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// One line of a menu description: the item name and its depth in the hierarchy.
+// A description is a pre-order list of entries, so every item is followed by its submenus.
+struct MenuEntry {
+    int depth;
+    std::string name;
+};
 
 // Define the MenuItem class to represent each menu
+// (pointer-based representation, kept as the baseline for the benchmark)
 class MenuItem {
 public:
     std::string name;
@@ -16,135 +43,989 @@ public:
     void addChild(std::shared_ptr<MenuItem> child) {
         children.push_back(child);
     }
+};
+
+// A node of the flat menu tree. Nodes are laid out breadth-first, so the children of a node
+// occupy the contiguous range [firstChild, firstChild + childCount).
+struct MenuNode {
+    uint32_t nameOffset;  // Offset of the name in the string pool
+    uint32_t nameLength;  // Length of the name in bytes
+    int32_t parent;       // Index of the parent node (-1 for the root)
+    int32_t firstChild;   // Index of the first child (-1 if there are no children)
+    int32_t nextSibling;  // Index of the next sibling (-1 for the last child)
+    uint32_t childCount;  // Number of children
+};
+
+// Header of a compiled menu image. The image is the header, followed by the node array
+// and the string pool, so it can be navigated in place once it is mapped into memory.
+struct MenuImageHeader {
+    char magic[4];       // "MENU"
+    uint32_t version;    // Image format version
+    uint32_t nodeCount;  // Number of MenuNode records after the header
+    uint32_t poolSize;   // Size of the string pool after the nodes, in bytes
+};
+
+const uint32_t kMenuImageVersion = 1;
+
+// Read-only menu tree: all nodes live in one contiguous array and all names in one string pool.
+// The tree is a view over a menu image, which is either built in memory or mapped from a file.
+// Navigating the tree is plain index arithmetic and never allocates.
+class MenuTree {
+private:
+    std::shared_ptr<const char> image;  // Keeps the image (heap buffer or file mapping) alive
+    size_t imageSize = 0;
+    const MenuNode* nodes = nullptr;
+    const char* namePool = nullptr;
+    uint32_t nodeCount = 0;
+
+    // Point the tree at an image after checking its header
+    void attach(std::shared_ptr<const char> data, size_t size) {
+        MenuImageHeader header;
+        if (size < sizeof(header)) {
+            throw std::runtime_error("menu image is truncated");
+        }
+        std::memcpy(&header, data.get(), sizeof(header));
+        if (std::memcmp(header.magic, "MENU", 4) != 0 || header.version != kMenuImageVersion) {
+            throw std::runtime_error("not a menu image or unsupported version");
+        }
+        if (header.nodeCount == 0 ||
+            size != sizeof(header) + size_t(header.nodeCount) * sizeof(MenuNode) + header.poolSize) {
+            throw std::runtime_error("menu image size does not match its header");
+        }
+        image = std::move(data);
+        imageSize = size;
+        nodeCount = header.nodeCount;
+        nodes = reinterpret_cast<const MenuNode*>(image.get() + sizeof(header));
+        namePool = image.get() + sizeof(header) + size_t(nodeCount) * sizeof(MenuNode);
+        validate(header.poolSize);
+    }
+
+    // One pass over the nodes so that navigation can trust them: names inside the pool, parents
+    // before their children (breadth-first), child ranges inside the array and pointing back at
+    // their parent, siblings chained in order, and every node but the root in exactly one range
+    void validate(uint32_t poolSize) const {
+        uint64_t children = 0;
+        for (uint32_t i = 0; i < nodeCount; ++i) {
+            const MenuNode& node = nodes[i];
+            bool ok = uint64_t(node.nameOffset) + node.nameLength <= poolSize &&
+                      (i == 0 ? node.parent == -1 : node.parent >= 0 && uint32_t(node.parent) < i) &&
+                      (node.childCount == 0 ? node.firstChild == -1
+                                            : node.firstChild > 0 && uint32_t(node.firstChild) > i &&
+                                                  uint64_t(node.firstChild) + node.childCount <= nodeCount);
+            for (uint32_t c = 0; ok && c < node.childCount; ++c) {
+                const MenuNode& child = nodes[node.firstChild + c];
+                int32_t next = c + 1 < node.childCount ? node.firstChild + int32_t(c) + 1 : -1;
+                ok = child.parent == int32_t(i) && child.nextSibling == next;
+            }
+            if (!ok) {
+                throw std::runtime_error("menu image is corrupt at node " + std::to_string(i));
+            }
+            children += node.childCount;
+        }
+        if (children != nodeCount - 1) {
+            throw std::runtime_error("menu image is corrupt: nodes outside the tree");
+        }
+    }
+
+public:
+    // Build the tree once from a pre-order description
+    static MenuTree build(const std::vector<MenuEntry>& entries) {
+        if (entries.empty() || entries[0].depth != 0) {
+            throw std::runtime_error("menu description must start with a single root at depth 0");
+        }
+
+        // Resolve the parent of every entry (in description order) with a stack of open menus
+        const size_t count = entries.size();
+        std::vector<int32_t> parentOf(count, -1);
+        std::vector<uint32_t> childCount(count, 0);
+        std::vector<int32_t> openMenus;
+        for (size_t i = 0; i < count; ++i) {
+            int depth = entries[i].depth;
+            if (i > 0 && (depth < 1 || depth > entries[i - 1].depth + 1)) {
+                throw std::runtime_error("invalid depth for menu item \"" + entries[i].name + "\"");
+            }
+            openMenus.resize(depth);
+            if (depth > 0) {
+                parentOf[i] = openMenus.back();
+                childCount[parentOf[i]]++;
+            }
+            openMenus.push_back(static_cast<int32_t>(i));
+        }
 
-    // Display the current menu with a cursor for selection
-    void displayMenu(int cursorIndex) {
-        std::cout << "\n" << name << ":\n";
-        for (size_t i = 0; i < children.size(); ++i) {
-            if (i == cursorIndex) {
-                std::cout << "> " << children[i]->name << "\n"; // Highlight the selected option
+        // Group the children of every entry together, keeping their description order
+        std::vector<uint32_t> childStart(count + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            childStart[i + 1] = childStart[i] + childCount[i];
+        }
+        std::vector<uint32_t> childList(count);
+        std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+        for (size_t i = 1; i < count; ++i) {
+            childList[fill[parentOf[i]]++] = static_cast<uint32_t>(i);
+        }
+
+        // Lay the nodes out breadth-first so that siblings end up next to each other
+        std::vector<MenuNode> flatNodes;
+        flatNodes.reserve(count);
+        std::string pool;
+        std::vector<uint32_t> order;
+        order.reserve(count);
+        std::vector<int32_t> flatIndex(count, -1);
+        std::unordered_map<std::string_view, uint32_t> interned;
+        order.push_back(0);
+        flatIndex[0] = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            uint32_t entry = order[i];
+            const std::string& name = entries[entry].name;
+
+            // Intern the name so that repeated labels share one copy in the pool
+            auto found = interned.find(name);
+            uint32_t offset;
+            if (found != interned.end()) {
+                offset = found->second;
             } else {
-                std::cout << "  " << children[i]->name << "\n"; // Regular unhighlighted option
+                offset = static_cast<uint32_t>(pool.size());
+                pool += name;
+                interned.emplace(name, offset);
+            }
+
+            MenuNode node;
+            node.nameOffset = offset;
+            node.nameLength = static_cast<uint32_t>(name.size());
+            node.parent = parentOf[entry] < 0 ? -1 : flatIndex[parentOf[entry]];
+            node.childCount = childCount[entry];
+            node.firstChild = node.childCount > 0 ? static_cast<int32_t>(order.size()) : -1;
+            node.nextSibling = -1;
+            for (uint32_t c = childStart[entry]; c < childStart[entry + 1]; ++c) {
+                flatIndex[childList[c]] = static_cast<int32_t>(order.size());
+                order.push_back(childList[c]);
+            }
+            flatNodes.push_back(node);
+        }
+        for (MenuNode& node : flatNodes) {
+            for (uint32_t c = 0; c + 1 < node.childCount; ++c) {
+                flatNodes[node.firstChild + c].nextSibling = node.firstChild + c + 1;
             }
         }
+
+        // Serialize header, nodes and pool into one image buffer
+        MenuImageHeader header;
+        std::memcpy(header.magic, "MENU", 4);
+        header.version = kMenuImageVersion;
+        header.nodeCount = static_cast<uint32_t>(flatNodes.size());
+        header.poolSize = static_cast<uint32_t>(pool.size());
+        size_t nodeBytes = flatNodes.size() * sizeof(MenuNode);
+        size_t size = sizeof(header) + nodeBytes + pool.size();
+        std::shared_ptr<char> buffer(new char[size], std::default_delete<char[]>());
+        std::memcpy(buffer.get(), &header, sizeof(header));
+        std::memcpy(buffer.get() + sizeof(header), flatNodes.data(), nodeBytes);
+        std::memcpy(buffer.get() + sizeof(header) + nodeBytes, pool.data(), pool.size());
+
+        MenuTree tree;
+        tree.attach(std::move(buffer), size);
+        return tree;
+    }
+
+    // Map a compiled menu image from disk. The image is used in place; loading it costs one
+    // validation pass over the nodes and never copies or parses the names.
+    static MenuTree map(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open menu image " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot read menu image " + path);
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping stays valid after the descriptor is closed
+        if (address == MAP_FAILED) {
+            throw std::runtime_error("cannot map menu image " + path);
+        }
+        std::shared_ptr<const char> mapping(static_cast<const char*>(address),
+                                            [size](const char* p) { ::munmap(const_cast<char*>(p), size); });
+
+        MenuTree tree;
+        tree.attach(std::move(mapping), size);
+        return tree;
+    }
+
+    // Write the image so it can be mapped later
+    void save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(image.get(), static_cast<std::streamsize>(imageSize));
+        if (!out) {
+            throw std::runtime_error("cannot write menu image " + path);
+        }
+    }
+
+    size_t size() const { return nodeCount; }
+    int32_t root() const { return 0; }
+    const MenuNode& node(int32_t index) const { return nodes[index]; }
+
+    std::string_view name(int32_t index) const {
+        const MenuNode& n = nodes[index];
+        return std::string_view(namePool + n.nameOffset, n.nameLength);
+    }
+
+    // Index of the child at the given position (children are contiguous)
+    int32_t child(int32_t index, uint32_t position) const {
+        return nodes[index].firstChild + static_cast<int32_t>(position);
+    }
+
+    // Bytes held by the menu image (node array and string pool)
+    size_t memoryUsage() const {
+        return imageSize;
     }
 };
 
-// Define the MenuSystem class for handling navigation
-class MenuSystem {
+// Parse a text menu description: one item per line, indented by two spaces per level.
+// Blank lines and lines starting with '#' are ignored.
+std::vector<MenuEntry> parseMenuDescription(std::istream& in) {
+    std::vector<MenuEntry> entries;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        size_t indent = line.find_first_not_of(' ');
+        if (indent == std::string::npos || line[indent] == '#') {
+            continue;
+        }
+        if (indent % 2 != 0) {
+            throw std::runtime_error("line " + std::to_string(lineNumber) + ": indentation must be a multiple of two spaces");
+        }
+        entries.push_back({static_cast<int>(indent / 2), line.substr(indent)});
+    }
+    return entries;
+}
+
+// Built-in copy of menu.txt, used only when the file is not found
+const char* kDefaultMenu =
+    "Main Menu\n"
+    "  Settings\n"
+    "    Display Settings\n"
+    "      Change Theme\n"
+    "    Audio Settings\n"
+    "      Volume Control\n"
+    "      Equalizer Settings\n"
+    "      Bluetooth Audio\n"
+    "  Media\n"
+    "    Radio\n"
+    "    Bluetooth Audio\n";
+
+// The menu hierarchy shown by the head unit when no menu image is given: menu.txt from the
+// working directory, which is the one source of truth for the menu
+std::vector<MenuEntry> defaultMenuDescription() {
+    std::ifstream file("menu.txt");
+    if (file) {
+        return parseMenuDescription(file);
+    }
+    std::istringstream in(kDefaultMenu);
+    return parseMenuDescription(in);
+}
+
+// One search hit: the matching menu item and how well it matched
+struct MenuSearchResult {
+    int32_t node;
+    int score;
+};
+
+// Search index over every item of a MenuTree, built once. Each item is indexed by its lowercase
+// name and full path ("settings > audio settings > equalizer settings"):
+//  - a sorted table of word starts answers prefix queries ("equ" -> "Equalizer Settings"),
+//  - a trigram index (posting lists over the full paths) finds substring and fuzzy matches.
+// Candidates are then ranked by exact, prefix, word-prefix, substring and trigram overlap matches.
+class MenuSearchIndex {
 private:
-    std::shared_ptr<MenuItem> rootMenu;      // The root menu
-    std::shared_ptr<MenuItem> currentMenu;   // The currently selected menu
-    std::vector<std::shared_ptr<MenuItem>> navigationHistory; // History for 'back' functionality
-    int cursorIndex;  // The current position of the cursor (which menu item is selected)
+    struct Text {
+        uint32_t nameOffset, nameLength;  // Lowercase name in the text pool
+        uint32_t pathOffset, pathLength;  // Lowercase full path in the text pool
+        uint32_t depth;
+    };
+    struct WordStart {
+        uint32_t offset;  // Start of the word in the text pool (runs to the end of the name)
+        uint32_t length;
+        int32_t node;
+    };
+
+    std::string textPool;
+    std::vector<Text> texts;                 // Indexed by node
+    std::vector<WordStart> wordStarts;       // Sorted by text
+    std::vector<uint32_t> trigramKeys;       // Sorted unique trigrams
+    std::vector<uint32_t> postingOffsets;    // Posting list of trigramKeys[i] is [offsets[i], offsets[i + 1])
+    std::vector<int32_t> postings;           // Node indices
+
+    // Scratch space reused by every query
+    mutable std::vector<uint32_t> hits;      // Per node: trigram hits, plus kPrefixHit
+    mutable std::vector<int32_t> touched;
+    mutable std::vector<uint32_t> queryTrigrams;
+    mutable std::string loweredQuery;
+
+    static const uint32_t kPrefixHit = 0x80000000u;
+
+    static char lower(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    static uint32_t trigram(const char* p) {
+        return (uint32_t(uint8_t(p[0])) << 16) | (uint32_t(uint8_t(p[1])) << 8) | uint32_t(uint8_t(p[2]));
+    }
+
+    std::string_view name(int32_t node) const {
+        return std::string_view(textPool.data() + texts[node].nameOffset, texts[node].nameLength);
+    }
+
+    std::string_view path(int32_t node) const {
+        return std::string_view(textPool.data() + texts[node].pathOffset, texts[node].pathLength);
+    }
+
+    std::string_view word(const WordStart& w) const {
+        return std::string_view(textPool.data() + w.offset, w.length);
+    }
+
+    // Rank one candidate; trigramHits is the number of query trigrams found in its path.
+    // Only candidates containing every query trigram can hold the query as a substring,
+    // so the others get their fuzzy score without touching the strings.
+    int score(int32_t node, std::string_view query, uint32_t trigramHits, bool prefixHit) const {
+        std::string_view itemName = name(node);
+        int value;
+        if (!prefixHit && trigramHits < queryTrigrams.size()) {
+            value = static_cast<int>(100 * trigramHits / queryTrigrams.size());
+        } else if (itemName == query) {
+            value = 1000;
+        } else if (itemName.compare(0, query.size(), query) == 0) {
+            value = 800;
+        } else if (size_t at = itemName.find(query); at != std::string_view::npos) {
+            value = (itemName[at - 1] == ' ') ? 600 : 400;  // Prefix of a later word, or inside a word
+        } else if (path(node).find(query) != std::string_view::npos) {
+            value = 200;
+        } else if (!queryTrigrams.empty()) {
+            value = static_cast<int>(100 * trigramHits / queryTrigrams.size());
+        } else {
+            value = 0;
+        }
+        // Prefer shallow items and short names among equal matches
+        return value * 16 - static_cast<int>(std::min<uint32_t>(texts[node].depth, 15));
+    }
 
 public:
-    MenuSystem() {
-        // Initialize root menu
-        rootMenu = std::make_shared<MenuItem>("Main Menu");
+    MenuSearchIndex() = default;
 
-        // Setting menu and its submenus
-        auto settingsMenu = std::make_shared<MenuItem>("Settings");
+    explicit MenuSearchIndex(const MenuTree& tree) {
+        const int32_t count = static_cast<int32_t>(tree.size());
+        texts.resize(count);
 
-        // Display settings menu and its theme options
-        auto displaySettings = std::make_shared<MenuItem>("Display Settings");
-        auto changeTheme = std::make_shared<MenuItem>("Change Theme");
-        displaySettings->addChild(changeTheme);
+        // Lowercase names and full paths; parents come first in the breadth-first layout
+        for (int32_t node = 0; node < count; ++node) {
+            Text& text = texts[node];
+            std::string_view itemName = tree.name(node);
+            int32_t parent = tree.node(node).parent;
+            text.pathOffset = static_cast<uint32_t>(textPool.size());
+            if (parent > 0) {
+                textPool.append(path(parent));
+                textPool += " > ";
+            }
+            text.nameOffset = static_cast<uint32_t>(textPool.size());
+            for (char c : itemName) {
+                textPool += lower(c);
+            }
+            text.nameLength = static_cast<uint32_t>(itemName.size());
+            text.pathLength = static_cast<uint32_t>(textPool.size()) - text.pathOffset;
+            text.depth = parent < 0 ? 0 : texts[parent].depth + 1;
+        }
+
+        // Word starts and trigrams of every item except the root
+        std::vector<std::pair<uint32_t, int32_t>> trigramPairs;
+        for (int32_t node = 1; node < count; ++node) {
+            std::string_view itemName = name(node);
+            for (size_t i = 0; i < itemName.size(); ++i) {
+                if (itemName[i] != ' ' && (i == 0 || itemName[i - 1] == ' ')) {
+                    wordStarts.push_back({texts[node].nameOffset + static_cast<uint32_t>(i),
+                                          static_cast<uint32_t>(itemName.size() - i), node});
+                }
+            }
+            std::string_view itemPath = path(node);
+            for (size_t i = 0; i + 3 <= itemPath.size(); ++i) {
+                trigramPairs.emplace_back(trigram(itemPath.data() + i), node);
+            }
+        }
+        std::sort(wordStarts.begin(), wordStarts.end(), [this](const WordStart& a, const WordStart& b) {
+            return word(a) < word(b);
+        });
+
+        // Posting lists: sorted, one entry per (trigram, node)
+        std::sort(trigramPairs.begin(), trigramPairs.end());
+        trigramPairs.erase(std::unique(trigramPairs.begin(), trigramPairs.end()), trigramPairs.end());
+        postings.reserve(trigramPairs.size());
+        for (size_t i = 0; i < trigramPairs.size(); ++i) {
+            if (i == 0 || trigramPairs[i].first != trigramPairs[i - 1].first) {
+                trigramKeys.push_back(trigramPairs[i].first);
+                postingOffsets.push_back(static_cast<uint32_t>(i));
+            }
+            postings.push_back(trigramPairs[i].second);
+        }
+        postingOffsets.push_back(static_cast<uint32_t>(postings.size()));
+
+        hits.assign(count, 0);
+    }
+
+    // Find the best matches for a query, best first. The results vector is reused by the caller.
+    void search(std::string_view query, size_t maxResults, std::vector<MenuSearchResult>& results) const {
+        results.clear();
+        loweredQuery.clear();
+        for (char c : query) {
+            loweredQuery += lower(c);
+        }
+        std::string_view q = loweredQuery;
+        if (q.empty() || texts.empty()) {
+            return;
+        }
 
-        // Audio settings menu with additional submenus
-        auto audioSettings = std::make_shared<MenuItem>("Audio Settings");
-        auto volumeControl = std::make_shared<MenuItem>("Volume Control");
-        auto equalizerSettings = std::make_shared<MenuItem>("Equalizer Settings");
-        auto bluetoothAudio = std::make_shared<MenuItem>("Bluetooth Audio");
+        // Candidates whose words start with the query
+        auto first = std::lower_bound(wordStarts.begin(), wordStarts.end(), q,
+                                      [this](const WordStart& w, std::string_view key) { return word(w) < key; });
+        for (auto it = first; it != wordStarts.end() && word(*it).compare(0, q.size(), q) == 0; ++it) {
+            if (hits[it->node] == 0) {
+                touched.push_back(it->node);
+            }
+            hits[it->node] |= kPrefixHit;
+        }
 
-        audioSettings->addChild(volumeControl);
-        audioSettings->addChild(equalizerSettings);
-        audioSettings->addChild(bluetoothAudio);
+        // Candidates sharing trigrams with the query (substring and fuzzy matches)
+        queryTrigrams.clear();
+        for (size_t i = 0; i + 3 <= q.size(); ++i) {
+            queryTrigrams.push_back(trigram(q.data() + i));
+        }
+        std::sort(queryTrigrams.begin(), queryTrigrams.end());
+        queryTrigrams.erase(std::unique(queryTrigrams.begin(), queryTrigrams.end()), queryTrigrams.end());
+        for (uint32_t key : queryTrigrams) {
+            auto found = std::lower_bound(trigramKeys.begin(), trigramKeys.end(), key);
+            if (found == trigramKeys.end() || *found != key) {
+                continue;
+            }
+            size_t k = static_cast<size_t>(found - trigramKeys.begin());
+            for (uint32_t p = postingOffsets[k]; p < postingOffsets[k + 1]; ++p) {
+                int32_t node = postings[p];
+                if (hits[node] == 0) {
+                    touched.push_back(node);
+                }
+                hits[node]++;
+            }
+        }
 
-        settingsMenu->addChild(displaySettings);
-        settingsMenu->addChild(audioSettings);
+        // Keep candidates matching at least half of the query trigrams, then rank them
+        size_t minimumHits = (queryTrigrams.size() + 1) / 2;
+        for (int32_t node : touched) {
+            bool prefixHit = (hits[node] & kPrefixHit) != 0;
+            uint32_t nodeHits = hits[node] & ~kPrefixHit;
+            hits[node] = 0;
+            if (prefixHit || (nodeHits > 0 && nodeHits >= minimumHits)) {
+                results.push_back({node, score(node, q, nodeHits, prefixHit)});
+            }
+        }
+        touched.clear();
 
-        // Media menu and its submenus
-        auto mediaMenu = std::make_shared<MenuItem>("Media");
-        auto radio = std::make_shared<MenuItem>("Radio");
-        auto bluetoothMedia = std::make_shared<MenuItem>("Bluetooth Audio");
-        mediaMenu->addChild(radio);
-        mediaMenu->addChild(bluetoothMedia);
+        auto better = [](const MenuSearchResult& a, const MenuSearchResult& b) {
+            return a.score != b.score ? a.score > b.score : a.node < b.node;
+        };
+        size_t keep = std::min(maxResults, results.size());
+        std::partial_sort(results.begin(), results.begin() + keep, results.end(), better);
+        results.resize(keep);
+    }
+};
 
-        // Add Settings and Media to the root menu
-        rootMenu->addChild(settingsMenu);
-        rootMenu->addChild(mediaMenu);
+// Terminal renderer that keeps the last frame and only rewrites the lines that changed
+// (usually the two rows where the '>' marker moved). Each frame is assembled in one buffer
+// and written with a single write() call. When stdout is not a terminal, full frames are written.
+class MenuRenderer {
+private:
+    std::vector<std::string> frame;      // Lines of the frame being composed (reused between frames)
+    std::vector<std::string> lastFrame;  // Lines currently on screen
+    size_t lineCount = 0;
+    size_t lastLineCount = 0;
+    std::string buffer;                  // Escape sequences and text for one write()
+    bool fullRedraw = true;
+    bool ansi;
 
-        currentMenu = rootMenu;  // Start at the root menu
-        cursorIndex = 0;         // Start with the first menu option selected
+    // Move the terminal cursor to the start of a (zero-based) row
+    void moveTo(size_t row) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), row + 1);
+        buffer += "\033[";
+        buffer.append(digits, result.ptr);
+        buffer += ";1H";
+    }
+
+    void writeBuffer() {
+        const char* data = buffer.data();
+        size_t remaining = buffer.size();
+        while (remaining > 0) {
+            ssize_t written = ::write(STDOUT_FILENO, data, remaining);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+    }
+
+public:
+    MenuRenderer() : ansi(::isatty(STDOUT_FILENO) != 0) {}
+
+    // Start composing a new frame
+    void beginFrame() {
+        lineCount = 0;
+    }
+
+    // Append a line to the frame and return it for filling in
+    std::string& addLine() {
+        if (lineCount == frame.size()) {
+            frame.emplace_back();
+        }
+        std::string& line = frame[lineCount++];
+        line.clear();
+        return line;
+    }
+
+    // Put the frame on screen followed by the prompt
+    void present(std::string_view prompt) {
+        buffer.clear();
+        if (!ansi) {
+            buffer += "\n";
+            for (size_t row = 0; row < lineCount; ++row) {
+                buffer += frame[row];
+                buffer += "\n";
+            }
+        } else {
+            if (fullRedraw) {
+                buffer += "\033[2J";  // Clear the screen
+            }
+            for (size_t row = 0; row < lineCount; ++row) {
+                if (!fullRedraw && row < lastLineCount && frame[row] == lastFrame[row]) {
+                    continue;  // Unchanged line
+                }
+                moveTo(row);
+                buffer += "\033[2K";  // Clear the line
+                buffer += frame[row];
+            }
+            // Clear everything below the frame: leftover rows, the old prompt and the echoed input
+            moveTo(lineCount);
+            buffer += "\033[J";
+        }
+        buffer += prompt;
+        writeBuffer();
+
+        std::swap(frame, lastFrame);
+        lastLineCount = lineCount;
+        fullRedraw = false;
+    }
+
+    // Redraw the whole screen on the next frame (e.g. after other output)
+    void invalidate() {
+        fullRedraw = true;
+    }
+};
+
+// Define the MenuSystem class for handling navigation
+class MenuSystem {
+private:
+    MenuTree tree;                          // The menu hierarchy (read-only)
+    int32_t currentMenu;                    // Index of the currently selected menu
+    std::vector<int32_t> navigationHistory; // History for 'back' functionality
+    uint32_t cursorIndex;                   // The current position of the cursor (which menu item is selected)
+    std::optional<MenuSearchIndex> searchIndex;  // Finds items anywhere; built on the first search
+    std::vector<MenuSearchResult> searchResults;
+    MenuRenderer renderer;                  // Draws the menu, rewriting only what changed
+    std::string statusMessage;              // Message shown under the options (e.g. invalid choice)
+
+    static const uint32_t kVisibleItems = 15;  // Menu rows shown at once; longer menus scroll
+
+public:
+    MenuSystem(MenuTree menuTree) : tree(std::move(menuTree)) {
+        currentMenu = tree.root();  // Start at the root menu
+        cursorIndex = 0;            // Start with the first menu option selected
+        navigationHistory.reserve(16);
+    }
+
+    // Display the current menu with a cursor for selection, followed by the navigation options
+    void render(std::string_view prompt = "Enter your choice: ") {
+        const MenuNode& menu = tree.node(currentMenu);
+        renderer.beginFrame();
+        renderer.addLine().append(tree.name(currentMenu)).append(":");
+
+        // Scroll long menus so that the cursor stays visible
+        uint32_t first = cursorIndex >= kVisibleItems ? cursorIndex - kVisibleItems + 1 : 0;
+        uint32_t last = std::min(menu.childCount, first + kVisibleItems);
+        for (uint32_t i = first; i < last; ++i) {
+            std::string& line = renderer.addLine();
+            line += (i == cursorIndex) ? "> " : "  ";  // Highlight the selected option
+            line.append(tree.name(tree.child(currentMenu, i)));
+        }
+
+        renderer.addLine();
+        renderer.addLine() = "Navigation Options:";
+        renderer.addLine() = "1. Move down";
+        renderer.addLine() = "2. Move up";
+        renderer.addLine() = "3. Enter submenu";
+        renderer.addLine() = "4. Go back to the parent menu";
+        renderer.addLine() = "5. Exit";
+        renderer.addLine() = "6. Search";
+        renderer.addLine() = statusMessage;
+        renderer.present(prompt);
     }
 
     // Function to handle navigation in the menu
     void navigate() {
         while (true) {
-            currentMenu->displayMenu(cursorIndex);
-            std::cout << "\nNavigation Options:\n";
-            std::cout << "1. Move down\n";
-            std::cout << "2. Move up\n";
-            std::cout << "3. Enter submenu\n";
-            std::cout << "4. Go back to the parent menu\n";
-            std::cout << "5. Exit\n";
+            render();
 
             int choice;
-            std::cout << "Enter your choice: ";
-            std::cin >> choice;
+            if (!readNumber(choice)) {
+                if (std::cin.eof()) {
+                    break;
+                }
+                statusMessage = "Invalid choice. Please enter a number.";
+                continue;
+            }
+            statusMessage.clear();
 
             if (choice == 1) {
                 // Move down (cursor goes to the next item)
-                if (cursorIndex < currentMenu->children.size() - 1) {
-                    cursorIndex++;
-                }
+                moveDown();
             } else if (choice == 2) {
                 // Move up (cursor goes to the previous item)
-                if (cursorIndex > 0) {
-                    cursorIndex--;
-                }
+                moveUp();
             } else if (choice == 3) {
                 // Enter submenu (if a submenu exists at the cursor position)
-                enterSubMenu();
+                if (!enterSubMenu()) {
+                    statusMessage = "No submenu to enter. Returning to previous menu.";
+                }
             } else if (choice == 4) {
                 // Go back to parent menu
-                goBack();
+                if (!goBack()) {
+                    statusMessage = "You are already at the root menu.";
+                }
+            } else if (choice == 6) {
+                // Search the whole menu and jump to a result
+                search();
             } else if (choice == 5) {
                 // Exit the menu system
                 std::cout << "Exiting the menu system...\n";
                 break;
             } else {
-                std::cout << "Invalid choice. Please try again.\n";
+                statusMessage = "Invalid choice. Please try again.";
             }
         }
     }
 
-    // Function to handle entering into a submenu
-    void enterSubMenu() {
-        if (currentMenu->children.empty()) {
-            std::cout << "No submenu to enter. Returning to previous menu.\n";
+    // Function to search the whole menu and jump straight to the chosen item
+    void search() {
+        render("Search for: ");
+        std::string query;
+        std::cin >> std::ws;
+        if (!std::getline(std::cin, query)) {
             return;
         }
-        navigationHistory.push_back(currentMenu); // Save current menu for 'back' functionality
-        currentMenu = currentMenu->children[cursorIndex];  // Enter the submenu at the cursor index
+        if (!searchIndex) {
+            searchIndex.emplace(tree);  // Sessions that never search never pay for the index
+        }
+        searchIndex->search(query, 9, searchResults);
+        if (searchResults.empty()) {
+            statusMessage = "No menu item matches \"" + query + "\".";
+            return;
+        }
+
+        renderer.beginFrame();
+        renderer.addLine() = "Search results for \"" + query + "\":";
+        for (size_t i = 0; i < searchResults.size(); ++i) {
+            renderer.addLine() = std::to_string(i + 1) + ". " + pathOf(searchResults[i].node);
+        }
+        renderer.addLine();
+        renderer.present("Select a result (0 to cancel): ");
+
+        size_t selection;
+        if (!readNumber(selection)) {
+            statusMessage = "Invalid selection.";
+        } else if (selection >= 1 && selection <= searchResults.size()) {
+            jumpTo(searchResults[selection - 1].node);
+        }
+    }
+
+    // Read a number from the console. On bad input, clear the error and skip the rest of the line
+    // so the next prompt starts clean; false on bad input or end of input.
+    template <typename T>
+    static bool readNumber(T& value) {
+        if (std::cin >> value) {
+            return true;
+        }
+        if (!std::cin.eof()) {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        return false;
+    }
+
+    // Full path of an item, e.g. "Settings > Audio Settings > Equalizer Settings"
+    std::string pathOf(int32_t node) const {
+        std::string path(tree.name(node));
+        for (int32_t parent = tree.node(node).parent; parent > 0; parent = tree.node(parent).parent) {
+            path.insert(0, " > ").insert(0, tree.name(parent));
+        }
+        return path;
+    }
+
+    // Select an item anywhere in the tree: open its parent menu, put the cursor on it
+    // and rebuild the navigation history as if the user had walked there
+    void jumpTo(int32_t node) {
+        navigationHistory.clear();
+        cursorIndex = 0;
+        if (node == tree.root()) {
+            currentMenu = tree.root();
+            return;
+        }
+        int32_t parent = tree.node(node).parent;
+        for (int32_t ancestor = tree.node(parent).parent; ancestor >= 0; ancestor = tree.node(ancestor).parent) {
+            navigationHistory.push_back(ancestor);
+        }
+        std::reverse(navigationHistory.begin(), navigationHistory.end());
+        currentMenu = parent;
+        cursorIndex = static_cast<uint32_t>(node - tree.node(parent).firstChild);
+    }
+
+    // Move the cursor to the next item
+    bool moveDown() {
+        if (cursorIndex + 1 < tree.node(currentMenu).childCount) {
+            cursorIndex++;
+            return true;
+        }
+        return false;
+    }
+
+    // Move the cursor to the previous item
+    bool moveUp() {
+        if (cursorIndex > 0) {
+            cursorIndex--;
+            return true;
+        }
+        return false;
+    }
+
+    // Function to handle entering into a submenu
+    bool enterSubMenu() {
+        if (tree.node(currentMenu).childCount == 0) {
+            return false;
+        }
+        navigationHistory.push_back(currentMenu);              // Save current menu for 'back' functionality
+        currentMenu = tree.child(currentMenu, cursorIndex);    // Enter the submenu at the cursor index
         cursorIndex = 0;  // Reset cursor position for the new submenu
+        return true;
     }
 
     // Function to go back to the parent menu
-    void goBack() {
-        if (!navigationHistory.empty()) {
-            currentMenu = navigationHistory.back();
-            navigationHistory.pop_back();
-            cursorIndex = 0;  // Reset cursor position when going back
-        } else {
-            std::cout << "You are already at the root menu.\n";
+    bool goBack() {
+        if (navigationHistory.empty()) {
+            return false;
         }
+        currentMenu = navigationHistory.back();
+        navigationHistory.pop_back();
+        cursorIndex = 0;  // Reset cursor position when going back
+        return true;
     }
+
+    int32_t current() const { return currentMenu; }
 };
 
-int main() {
-    MenuSystem menuSystem;
-    menuSystem.navigate();  // Start the navigation system
+// Build the pointer-based menu graph from a description (the previous MenuSystem representation)
+std::shared_ptr<MenuItem> buildMenuItems(const std::vector<MenuEntry>& entries) {
+    std::vector<std::shared_ptr<MenuItem>> openMenus;
+    for (const MenuEntry& entry : entries) {
+        auto item = std::make_shared<MenuItem>(entry.name);
+        openMenus.resize(entry.depth);
+        if (!openMenus.empty()) {
+            openMenus.back()->addChild(item);
+        }
+        openMenus.push_back(item);
+    }
+    return openMenus.empty() ? nullptr : openMenus.front();
+}
+
+// Approximate heap footprint of the pointer-based menu graph
+size_t menuItemMemoryUsage(const MenuItem& item) {
+    // make_shared places the object next to its control block (two counters and a vtable pointer)
+    size_t bytes = sizeof(MenuItem) + 2 * sizeof(long) + sizeof(void*);
+    bytes += item.children.capacity() * sizeof(std::shared_ptr<MenuItem>);
+    if (item.name.capacity() > 15) {
+        bytes += item.name.capacity() + 1;  // Names that do not fit the small-string buffer
+    }
+    for (const auto& child : item.children) {
+        bytes += menuItemMemoryUsage(*child);
+    }
+    return bytes;
+}
+
+// Generate a large menu description similar to the per-market feature menus
+std::vector<MenuEntry> generateMenuDescription(int categories, int groups, int options) {
+    std::vector<MenuEntry> entries;
+    entries.push_back({0, "Main Menu"});
+    for (int c = 0; c < categories; ++c) {
+        entries.push_back({1, "Category " + std::to_string(c)});
+        for (int g = 0; g < groups; ++g) {
+            entries.push_back({2, "Feature Group " + std::to_string(g)});
+            for (int o = 0; o < options; ++o) {
+                entries.push_back({3, "Feature Option " + std::to_string(o)});
+            }
+        }
+    }
+    return entries;
+}
+
+// Compare the flat MenuTree with the pointer-based graph: build time, memory and per-keystroke latency
+void runBenchmark() {
+    using Clock = std::chrono::steady_clock;
+    const std::vector<MenuEntry> entries = generateMenuDescription(20, 20, 25);
+    std::cout << "Menu items: " << entries.size() << "\n";
+
+    auto start = Clock::now();
+    std::shared_ptr<MenuItem> rootItem = buildMenuItems(entries);
+    double legacyBuildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    MenuTree tree = MenuTree::build(entries);
+    double flatBuildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << "Build time:  shared_ptr graph " << legacyBuildMs << " ms, flat tree " << flatBuildMs << " ms\n";
+    std::cout << "Memory:      shared_ptr graph " << menuItemMemoryUsage(*rootItem) / 1024 << " KiB, flat tree "
+              << tree.memoryUsage() / 1024 << " KiB\n";
+
+    // Cold start from a compiled image: map it and read the root menu
+    std::string imagePath =
+        (std::filesystem::temp_directory_path() / ("menu_bench_" + std::to_string(::getpid()) + ".img")).string();
+    tree.save(imagePath);
+    start = Clock::now();
+    MenuTree mapped = MenuTree::map(imagePath);
+    std::string_view firstItem = mapped.name(mapped.child(mapped.root(), 0));
+    double mapUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    std::remove(imagePath.c_str());
+    std::cout << "Cold start:  mapped image ready in " << mapUs << " us (first item \"" << firstItem << "\")\n";
+
+    // Search latency over the whole menu (prefix, substring, fuzzy and path queries)
+    MenuSearchIndex searchIndex(mapped);
+    const char* queries[] = {"fea", "option 12", "featre grup", "category 7 > feature group 3", "volume"};
+    std::vector<MenuSearchResult> results;
+    const int searchRounds = 200;
+    size_t resultCount = 0;
+    start = Clock::now();
+    for (int round = 0; round < searchRounds; ++round) {
+        for (const char* query : queries) {
+            searchIndex.search(query, 10, results);
+            resultCount += results.size();
+        }
+    }
+    double searchUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() /
+                      (searchRounds * (sizeof(queries) / sizeof(queries[0])));
+    std::cout << "Search:      " << searchUs << " us per query\n";
+
+    // Replay the same random key sequence on both representations
+    const int keystrokes = 2000000;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> keyDist(1, 4);
+    std::vector<int> keys(keystrokes);
+    for (int& key : keys) {
+        key = keyDist(gen);
+    }
+
+    // Pointer-based navigation, as done by the previous MenuSystem
+    start = Clock::now();
+    std::shared_ptr<MenuItem> currentMenu = rootItem;
+    std::vector<std::shared_ptr<MenuItem>> history;
+    size_t cursor = 0;
+    size_t legacyChecksum = 0;
+    for (int key : keys) {
+        if (key == 1 && cursor + 1 < currentMenu->children.size()) {
+            cursor++;
+        } else if (key == 2 && cursor > 0) {
+            cursor--;
+        } else if (key == 3 && !currentMenu->children.empty()) {
+            history.push_back(currentMenu);
+            currentMenu = currentMenu->children[cursor];
+            cursor = 0;
+        } else if (key == 4 && !history.empty()) {
+            currentMenu = history.back();
+            history.pop_back();
+            cursor = 0;
+        }
+        legacyChecksum += cursor + currentMenu->name.size();
+    }
+    double legacyNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / keystrokes;
+
+    MenuSystem menuSystem(std::move(tree));
+    start = Clock::now();
+    size_t flatChecksum = 0;
+    for (int key : keys) {
+        if (key == 1) {
+            menuSystem.moveDown();
+        } else if (key == 2) {
+            menuSystem.moveUp();
+        } else if (key == 3) {
+            menuSystem.enterSubMenu();
+        } else {
+            menuSystem.goBack();
+        }
+        flatChecksum += menuSystem.current();
+    }
+    double flatNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / keystrokes;
+
+    std::cout << "Keystroke:   shared_ptr graph " << legacyNs << " ns, flat tree " << flatNs << " ns\n";
+
+    // Keep the navigation loops from being optimized away
+    volatile size_t sink = legacyChecksum + flatChecksum + resultCount;
+    (void)sink;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    try {
+        if (args.size() == 1 && args[0] == "--bench") {
+            runBenchmark();
+            return 0;
+        }
+
+        // Compile a text menu description into a binary menu image
+        if (args.size() == 3 && args[0] == "--compile") {
+            std::ifstream in(args[1]);
+            if (!in) {
+                throw std::runtime_error("cannot open menu description " + args[1]);
+            }
+            MenuTree tree = MenuTree::build(parseMenuDescription(in));
+            tree.save(args[2]);
+            std::cout << "Compiled " << tree.size() << " menu items into " << args[2] << "\n";
+            return 0;
+        }
+
+        // Navigate a compiled menu image in place
+        if (args.size() == 2 && args[0] == "--image") {
+            MenuSystem menuSystem(MenuTree::map(args[1]));
+            menuSystem.navigate();
+            return 0;
+        }
+
+        if (!args.empty()) {
+            std::cerr << "Usage: " << argv[0] << " [--image menu.img | --compile menu.txt menu.img | --bench]\n";
+            return 1;
+        }
+
+        MenuSystem menuSystem(MenuTree::build(defaultMenuDescription()));
+        menuSystem.navigate();  // Start the navigation system
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
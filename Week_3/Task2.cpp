@@ -3,7 +3,23 @@
 #include <mutex>
 #include <random>
 #include <chrono>
-#include <algorithm>  
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <iomanip>
+#include <deque>
+
+// Snapshot of the vehicle data as seen by the display
+struct VehicleSnapshot {
+    int speed;
+    int fuel;
+    int temperature;
+};
 
 // VehicleData class stores and updates the data for speed, fuel, and temperature
 class VehicleData {
@@ -11,13 +27,11 @@ public:
     int speed;
     int fuel;
     int temperature;
-   
+
     VehicleData() : speed(0), fuel(100), temperature(80) {}
 
     // Update the vehicle data: speed, fuel, and temperature
-    void update() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
+    void update(std::mt19937& gen) {
         std::uniform_int_distribution<> speedDist(0, 120);  // Random speed between 0 and 120 km/h
         std::uniform_int_distribution<> fuelDist(-2, 0);     // Random fuel change (-2 to 0)
         std::uniform_int_distribution<> tempDist(-2, 2);     // Random temperature change (-2 to 2)
@@ -27,63 +41,912 @@ public:
         fuel += fuelDist(gen);
         fuel = std::max(0, fuel);  // Ensure fuel is not less than 0
         temperature += tempDist(gen);
+    }
+
+    VehicleSnapshot snapshot() const {
+        return {speed, fuel, temperature};
+    }
+};
+
+// Random generator of the calling thread, seeded once and reused for every sample
+std::mt19937& threadGenerator() {
+    thread_local std::mt19937 gen(std::random_device{}());
+    return gen;
+}
+
+// Timing statistics of the update loop, written by the updater and read by the display
+struct SamplingStats {
+    std::atomic<uint64_t> updates{0};
+    std::atomic<uint64_t> missedDeadlines{0};  // Deadlines skipped because an update overran its period
+    std::atomic<uint64_t> totalLatenessNs{0};  // Sum of (wake-up time - deadline)
+    std::atomic<uint64_t> maxLatenessNs{0};
+
+    void record(uint64_t latenessNs) {
+        updates.fetch_add(1, std::memory_order_relaxed);
+        totalLatenessNs.fetch_add(latenessNs, std::memory_order_relaxed);
+        if (latenessNs > maxLatenessNs.load(std::memory_order_relaxed)) {
+            maxLatenessNs.store(latenessNs, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Wait-free triple buffer between one writer and one reader.
+// The writer fills its private back buffer and swaps it with the shared middle buffer;
+// the reader swaps its private front buffer with the middle one when a fresh value is there.
+// Neither side ever waits for the other, and the reader always sees a complete snapshot.
+template <typename T>
+class TripleBuffer {
+private:
+    static const uint8_t kIndexMask = 0x3;
+    static const uint8_t kFresh = 0x4;  // Set when the middle buffer holds an unread value
+
+    T buffers[3];
+    std::atomic<uint8_t> middle;  // Index of the shared buffer, plus the kFresh flag
+    uint8_t back = 1;             // Only touched by the writer
+    uint8_t front = 2;            // Only touched by the reader
+
+public:
+    explicit TripleBuffer(const T& initial) : buffers{initial, initial, initial}, middle(0) {}
+
+    // Publish a new value (writer side)
+    void publish(const T& value) {
+        buffers[back] = value;
+        back = middle.exchange(back | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Get the latest published value (reader side)
+    const T& read() {
+        if (middle.load(std::memory_order_relaxed) & kFresh) {
+            front = middle.exchange(front, std::memory_order_acq_rel) & kIndexMask;
+        }
+        return buffers[front];
+    }
+};
+
+// Identifies a signal in the telemetry store
+using SignalId = uint32_t;
+
+// Summary of the samples of one signal inside a time window
+struct WindowStats {
+    size_t count;
+    float min;
+    float max;
+    float mean;
+};
+
+// History of many signals. Every signal has a fixed-size ring buffer of timestamped samples,
+// kept as separate timestamp and value arrays (structure of arrays), so appends are O(1)
+// and window queries run tight loops over contiguous floats.
+// One thread appends; any thread may query without locking. Before overwriting a slot the writer
+// publishes how far it is about to write (a release fence orders that before the slot stores);
+// a reader copies the samples out, then checks through an acquire fence that the writer had not
+// started overwriting them, and retries otherwise. Slots are relaxed atomics, so a racing overwrite
+// is not a data race, and the copied-out window is reduced as plain floats.
+class TelemetryStore {
+private:
+    size_t capacity;                         // Samples per signal (power of two)
+    size_t mask;
+    std::vector<std::string> names;
+    std::unique_ptr<std::atomic<int64_t>[]> timestamps;  // [signal * capacity + slot], nanoseconds
+    std::unique_ptr<std::atomic<float>[]> values;        // [signal * capacity + slot]
+    std::unique_ptr<std::atomic<uint64_t>[]> heads;  // Samples ever appended, per signal
+    std::unique_ptr<std::atomic<uint64_t>[]> claims;  // Samples the writer has started to write, per signal
+
+    // Logical sample index -> position in the arrays
+    size_t slot(SignalId signal, uint64_t index) const {
+        return signal * capacity + (index & mask);
+    }
+
+    // Copy a contiguous run of values out of the ring
+    static void copyOut(const std::atomic<float>* data, size_t n, float* out) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = data[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Min/max/sum over plain floats, four lanes at a time (GCC vector extensions: the float sum
+    // is a reduction the auto-vectorizer will not reorder without -ffast-math)
+    static void accumulate(const float* data, size_t n, float& lo, float& hi, double& sum) {
+        typedef float FloatLanes __attribute__((vector_size(16)));
+        const size_t lanes = sizeof(FloatLanes) / sizeof(float);
+        FloatLanes mins = FloatLanes{} + lo, maxs = FloatLanes{} + hi, sums = FloatLanes{};
+        size_t i = 0;
+        for (; i + lanes <= n; i += lanes) {
+            FloatLanes v;
+            std::memcpy(&v, data + i, sizeof(v));
+            mins = v < mins ? v : mins;
+            maxs = v > maxs ? v : maxs;
+            sums += v;
+        }
+        float runSum = 0.0f;
+        for (size_t l = 0; l < lanes; ++l) {
+            lo = std::min(lo, mins[l]);
+            hi = std::max(hi, maxs[l]);
+            runSum += sums[l];
+        }
+        for (; i < n; ++i) {
+            lo = std::min(lo, data[i]);
+            hi = std::max(hi, data[i]);
+            runSum += data[i];
+        }
+        sum += runSum;
+    }
+
+public:
+    TelemetryStore(const std::vector<std::string>& signalNames, size_t samplesPerSignal) : names(signalNames) {
+        capacity = 1;
+        while (capacity < samplesPerSignal) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        timestamps.reset(new std::atomic<int64_t>[names.size() * capacity]);
+        values.reset(new std::atomic<float>[names.size() * capacity]);
+        for (size_t i = 0; i < names.size() * capacity; ++i) {
+            timestamps[i].store(0, std::memory_order_relaxed);
+            values[i].store(0.0f, std::memory_order_relaxed);
+        }
+        heads.reset(new std::atomic<uint64_t>[names.size()]);
+        claims.reset(new std::atomic<uint64_t>[names.size()]);
+        for (size_t i = 0; i < names.size(); ++i) {
+            heads[i].store(0);
+            claims[i].store(0);
+        }
+    }
+
+    size_t signalCount() const { return names.size(); }
+    const std::string& name(SignalId signal) const { return names[signal]; }
+
+    // Append a sample (single writer); timestamps of a signal must not decrease
+    void append(SignalId signal, int64_t timestampNs, float value) {
+        uint64_t head = heads[signal].load(std::memory_order_relaxed);
+        size_t at = slot(signal, head);
+        // Announce the overwrite before doing it: a reader that sees the new slot contents
+        // is then guaranteed to see the claim when it re-checks
+        claims[signal].store(head + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        timestamps[at].store(timestampNs, std::memory_order_relaxed);
+        values[at].store(value, std::memory_order_relaxed);
+        heads[signal].store(head + 1, std::memory_order_release);
+    }
+
+    // Min, max and mean of the samples with fromNs <= timestamp < toNs
+    WindowStats query(SignalId signal, int64_t fromNs, int64_t toNs) const {
+        while (true) {
+            uint64_t head = heads[signal].load(std::memory_order_acquire);
+            // Leave one slot of slack: the writer may be filling the slot after the head
+            uint64_t available = std::min<uint64_t>(head, capacity - 1);
+            uint64_t oldest = head - available;
+
+            // Binary search for the first and last samples in the window (timestamps are sorted)
+            auto firstAtOrAfter = [&](int64_t t) {
+                uint64_t lo = oldest, hi = head;
+                while (lo < hi) {
+                    uint64_t mid = lo + (hi - lo) / 2;
+                    if (timestamps[slot(signal, mid)].load(std::memory_order_relaxed) < t) {
+                        lo = mid + 1;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                return lo;
+            };
+            uint64_t begin = firstAtOrAfter(fromNs);
+            uint64_t end = firstAtOrAfter(toNs);
+
+            // Copy the window out; it is at most two contiguous runs of the ring buffer
+            thread_local std::vector<float> window;
+            size_t n = begin < end ? static_cast<size_t>(end - begin) : 0;
+            window.resize(n);
+            if (n > 0) {
+                size_t first = slot(signal, begin);
+                size_t rowEnd = signal * capacity + capacity;
+                size_t firstRun = std::min(n, rowEnd - first);
+                copyOut(&values[first], firstRun, window.data());
+                copyOut(&values[signal * capacity], n - firstRun, window.data() + firstRun);
+            }
+
+            // Retry if the writer had started overwriting any sample we read (writing sample i
+            // overwrites sample i - capacity). The acquire fence pairs with the writer's release
+            // fence: if a slot read saw an overwrite, this load sees its claim.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (claims[signal].load(std::memory_order_relaxed) - oldest > capacity) {
+                continue;
+            }
+
+            WindowStats stats{n, std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 0.0f};
+            if (n == 0) {
+                stats.min = stats.max = 0.0f;
+                return stats;
+            }
+            double sum = 0.0;
+            accumulate(window.data(), n, stats.min, stats.max, sum);
+            stats.mean = static_cast<float>(sum / n);
+            return stats;
+        }
+    }
+
+    // Most recent sample of a signal (0 if there is none)
+    float latest(SignalId signal) const {
+        uint64_t head = heads[signal].load(std::memory_order_acquire);
+        return head == 0 ? 0.0f : values[slot(signal, head - 1)].load(std::memory_order_relaxed);
+    }
+};
+
+// Signals of the vehicle, registered in this order in the telemetry store
+enum VehicleSignal : SignalId {
+    kSpeedSignal,
+    kFuelSignal,
+    kTemperatureSignal
+};
+
+// Current time on the telemetry clock
+int64_t telemetryNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Render the trend of a signal over the last seconds as a small bar graph
+std::string trendGraph(const TelemetryStore& store, SignalId signal, int64_t nowNs, int seconds, float lo, float hi) {
+    static const char* bars[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+    const int columns = 20;
+    const int64_t span = int64_t(seconds) * 1000000000LL;
+    std::string graph;
+    for (int column = 0; column < columns; ++column) {
+        int64_t from = nowNs - span + span * column / columns;
+        int64_t to = nowNs - span + span * (column + 1) / columns;
+        WindowStats stats = store.query(signal, from, to);
+        if (stats.count == 0) {
+            graph += " ";
+            continue;
+        }
+        int level = static_cast<int>((stats.mean - lo) / (hi - lo) * 8);
+        graph += bars[std::clamp(level, 0, 7)];
+    }
+    return graph;
+}
+
+// Direction of a warning rule
+enum class RuleCondition : uint8_t {
+    Above,  // Raise when the signal goes above the threshold
+    Below   // Raise when the signal goes below the threshold
+};
+
+// Definition of a dashboard warning
+struct WarningRule {
+    SignalId signal;
+    RuleCondition condition;
+    float threshold;       // Raise once the signal is past this value...
+    float clearThreshold;  // ...and clear only once it is back past this one (hysteresis)
+    uint32_t debounce;     // Consecutive samples needed before raising or clearing
+    std::string message;
+};
+
+// Edge-triggered warning notification
+struct WarningEvent {
+    uint32_t rule;
+    bool raised;  // true when the warning was raised, false when it cleared
+    int64_t timestampNs;
+};
+
+// A batch of samples of every signal, one column per signal (structure of arrays)
+class SampleBatch {
+private:
+    size_t capacity;
+    size_t count = 0;
+    std::vector<int64_t> timestamps;
+    std::vector<float> values;  // [signal * capacity + sample]
+
+public:
+    SampleBatch(size_t signals, size_t samples)
+        : capacity(samples), timestamps(samples), values(signals * samples) {}
+
+    // Start a new frame (one sample of every signal) and return its index
+    size_t addFrame(int64_t timestampNs) {
+        timestamps[count] = timestampNs;
+        return count++;
+    }
+
+    void set(SignalId signal, size_t frame, float value) { values[signal * capacity + frame] = value; }
+    const float* column(SignalId signal) const { return &values[signal * capacity]; }
+    int64_t timestamp(size_t frame) const { return timestamps[frame]; }
+    size_t size() const { return count; }
+    bool full() const { return count == capacity; }
+    void clear() { count = 0; }
+};
+
+// Warning rules compiled into parallel arrays, grouped by signal.
+// A batch is evaluated rule by rule over contiguous signal columns: a branch-free pass classifies
+// every sample against the thresholds (GCC vectorizes it at -O3; the -O2 cost model does not take
+// the mixed float/byte loop), and the debounce/hysteresis state machine
+// only runs when something is past a threshold or the warning is active.
+class WarningEngine {
+private:
+    std::vector<WarningRule> rules;  // As added; indices are the rule ids
+
+    // Compiled form, sorted by signal
+    std::vector<uint32_t> ruleIds;
+    std::vector<SignalId> signals;
+    std::vector<float> direction;   // +1 for Above, -1 for Below: all checks become "value * direction > limit"
+    std::vector<float> raiseLimit;  // threshold * direction
+    std::vector<float> clearLimit;  // clearThreshold * direction
+    std::vector<uint32_t> debounce;
+
+    // Evaluation state per compiled rule
+    std::vector<uint32_t> streak;
+    std::vector<uint8_t> active;
+
+    // Scratch masks for one column
+    std::vector<uint8_t> overRaise;
+    std::vector<uint8_t> underClear;
+
+public:
+    uint32_t addRule(const WarningRule& rule) {
+        rules.push_back(rule);
+        return static_cast<uint32_t>(rules.size() - 1);
+    }
+
+    // Build the evaluation tables; call once after adding the rules
+    void compile() {
+        ruleIds.resize(rules.size());
+        for (uint32_t i = 0; i < rules.size(); ++i) {
+            ruleIds[i] = i;
+        }
+        std::stable_sort(ruleIds.begin(), ruleIds.end(), [this](uint32_t a, uint32_t b) {
+            return rules[a].signal < rules[b].signal;
+        });
+        signals.clear();
+        direction.clear();
+        raiseLimit.clear();
+        clearLimit.clear();
+        debounce.clear();
+        for (uint32_t id : ruleIds) {
+            const WarningRule& rule = rules[id];
+            float sign = rule.condition == RuleCondition::Above ? 1.0f : -1.0f;
+            signals.push_back(rule.signal);
+            direction.push_back(sign);
+            raiseLimit.push_back(rule.threshold * sign);
+            clearLimit.push_back(rule.clearThreshold * sign);
+            debounce.push_back(std::max<uint32_t>(rule.debounce, 1));
+        }
+        streak.assign(ruleIds.size(), 0);
+        active.assign(ruleIds.size(), 0);
+    }
+
+    size_t ruleCount() const { return rules.size(); }
+    const std::string& message(uint32_t rule) const { return rules[rule].message; }
+
+    // Evaluate every rule over a batch and append the raised/cleared edges to events
+    void evaluate(const SampleBatch& batch, std::vector<WarningEvent>& events) {
+        const size_t n = batch.size();
+        overRaise.resize(n);
+        underClear.resize(n);
+        for (size_t r = 0; r < ruleIds.size(); ++r) {
+            const float* column = batch.column(signals[r]);
+            const float sign = direction[r];
+            const float raise = raiseLimit[r];
+            const float clear = clearLimit[r];
+
+            // Classify the whole column first (no branches, vectorizable). The masks are written
+            // through local restrict pointers: byte stores into the member vectors could alias
+            // anything, including this, which stops the vectorizer.
+            const float* __restrict samples = column;
+            uint8_t* __restrict over = overRaise.data();
+            uint8_t* __restrict under = underClear.data();
+            uint8_t anyOver = 0;
+            for (size_t i = 0; i < n; ++i) {
+                float v = samples[i] * sign;
+                uint8_t isOver = v > raise;
+                over[i] = isOver;
+                under[i] = v < clear;
+                anyOver |= isOver;
+            }
+            if (!active[r] && !anyOver) {
+                streak[r] = 0;
+                continue;  // Nothing can be raised in this batch
+            }
+
+            // Debounce and hysteresis, sample by sample
+            for (size_t i = 0; i < n; ++i) {
+                bool towardsChange = active[r] ? underClear[i] : overRaise[i];
+                streak[r] = towardsChange ? streak[r] + 1 : 0;
+                if (streak[r] >= debounce[r]) {
+                    active[r] = !active[r];
+                    streak[r] = 0;
+                    events.push_back({ruleIds[r], active[r] != 0, batch.timestamp(i)});
+                }
+            }
+        }
+    }
+};
+
+// Bounded single-producer/single-consumer queue (push fails when full; the producer keeps the item)
+template <typename T, size_t Capacity>
+class SpscQueue {
+private:
+    T items[Capacity];
+    std::atomic<size_t> head{0};  // Next item to pop (consumer)
+    std::atomic<size_t> tail{0};  // Next free slot (producer)
 
-        
-        
+public:
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items[t % Capacity] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[h % Capacity];
+        head.store(h + 1, std::memory_order_release);
+        return true;
     }
 };
 
+using WarningQueue = SpscQueue<WarningEvent, 1024>;
+
+// The dashboard warnings: the checks that used to be hard-coded in the display loop
+void addDashboardRules(WarningEngine& engine) {
+    engine.addRule({kFuelSignal, RuleCondition::Below, 10.0f, 12.0f, 1, "Warning: Low Fuel!"});
+    engine.addRule({kTemperatureSignal, RuleCondition::Above, 100.0f, 98.0f, 2, "Warning: High Temperature!"});
+    engine.addRule({kFuelSignal, RuleCondition::Below, 0.5f, 0.5f, 1, "Switched to Electric Mode!"});
+    engine.compile();
+}
+
 // Function to display the vehicle data in real-time
-void displayData(VehicleData& data, std::mutex& dataMutex) {
-    while (true) {
-        {
-            std::lock_guard<std::mutex> lock(dataMutex);  // Lock the data to safely access it
-            std::cout << "\033[2J\033[1;1H";  // Clear the console screen (ANSI escape sequence)
-
-            // Display the current vehicle data
-            std::cout << "Speed: " << data.speed << " km/h\n";
-            std::cout << "Fuel: " << data.fuel << "%\n";
-            std::cout << "Temperature: " << data.temperature << "°C\n";
-
-            // Check for warning conditions
-            if (data.fuel < 10) {
-                std::cout << "Warning: Low Fuel!\n";
+void displayData(TripleBuffer<VehicleSnapshot>& channel, const TelemetryStore& store, const WarningEngine& engine,
+                 WarningQueue& warnings, const SamplingStats& stats, const std::atomic<bool>& running) {
+    using Clock = std::chrono::steady_clock;
+    const int64_t startNs = telemetryNow();
+    std::vector<uint8_t> activeWarnings(engine.ruleCount(), 0);
+    std::deque<WarningEvent> recentEvents;  // Last few raised/cleared edges
+    uint64_t lastUpdates = 0;
+    auto lastTime = Clock::now();
+    while (running.load(std::memory_order_relaxed)) {
+        VehicleSnapshot data = channel.read();  // Never blocks the updater
+        std::cout << "\033[2J\033[1;1H";  // Clear the console screen (ANSI escape sequence)
+
+        // Display the current vehicle data
+        std::cout << "Speed: " << data.speed << " km/h\n";
+        std::cout << "Fuel: " << data.fuel << "%\n";
+        std::cout << "Temperature: " << data.temperature << "°C\n";
+
+        // Apply the warning edges raised or cleared by the rule engine since the last frame
+        WarningEvent event;
+        while (warnings.pop(event)) {
+            activeWarnings[event.rule] = event.raised;
+            recentEvents.push_back(event);
+            if (recentEvents.size() > 5) {
+                recentEvents.pop_front();
             }
-            if (data.temperature > 100) {
-                std::cout << "Warning: High Temperature!\n";
+        }
+        for (uint32_t rule = 0; rule < activeWarnings.size(); ++rule) {
+            if (activeWarnings[rule]) {
+                std::cout << engine.message(rule) << "\n";
             }
-             // If fuel reaches 0 and the vehicle isn't already in electric mode, switch to Electric mode
-        if (data.fuel == 0 ) {
-           
-            std::cout << "Switched to Electric Mode!\n";  // Notify mode change
         }
+        if (!recentEvents.empty()) {
+            std::cout << "\nRecent events:\n";
+            for (const WarningEvent& e : recentEvents) {
+                std::cout << "  " << std::setw(8) << (e.timestampNs - startNs) / 1000000 << " ms  "
+                          << (e.raised ? "raised   " : "cleared  ") << engine.message(e.rule) << "\n";
+            }
         }
+
+        // Trends over the last 10 seconds, straight from the telemetry history
+        const int trendSeconds = 10;
+        int64_t nowNs = telemetryNow();
+        std::cout << "\nLast " << trendSeconds << " s        min    avg    max  trend\n";
+        auto printTrend = [&](SignalId signal, const char* label, float lo, float hi) {
+            WindowStats window = store.query(signal, nowNs - trendSeconds * 1000000000LL, nowNs + 1);
+            std::cout << std::left << std::setw(13) << label << std::right
+                      << std::setw(6) << static_cast<int>(window.min) << " " << std::setw(6) << static_cast<int>(window.mean)
+                      << " " << std::setw(6) << static_cast<int>(window.max) << "  "
+                      << trendGraph(store, signal, nowNs, trendSeconds, lo, hi) << "\n";
+        };
+        printTrend(kSpeedSignal, "Speed", 0, 120);
+        printTrend(kFuelSignal, "Fuel", 0, 100);
+        printTrend(kTemperatureSignal, "Temperature", 60, 110);
+
+        // Update rate achieved since the previous frame
+        uint64_t updates = stats.updates.load(std::memory_order_relaxed);
+        auto now = Clock::now();
+        double seconds = std::chrono::duration<double>(now - lastTime).count();
+        std::cout << "Update rate: " << static_cast<int>((updates - lastUpdates) / seconds) << " Hz\n";
+        lastUpdates = updates;
+        lastTime = now;
+        std::cout.flush();
         std::this_thread::sleep_for(std::chrono::seconds(1));  // Sleep for 1 second
     }
 }
 
-// Function to update the vehicle data in real-time
-void updateData(VehicleData& data, std::mutex& dataMutex) {
-    while (true) {
-        {
-            std::lock_guard<std::mutex> lock(dataMutex);  // Lock the data to safely update it
-            data.update();  // Update the data (speed, fuel, temperature)
+// Wait for an absolute deadline: sleep for most of the time, then spin for the last stretch,
+// since a plain sleep can wake up tens of microseconds late
+void waitUntil(std::chrono::steady_clock::time_point deadline) {
+    const auto spinWindow = std::chrono::microseconds(100);
+    auto now = std::chrono::steady_clock::now();
+    if (deadline - now > spinWindow) {
+        std::this_thread::sleep_until(deadline - spinWindow);
+    }
+    while (std::chrono::steady_clock::now() < deadline) {
+    }
+}
+
+// Function to update the vehicle data in real-time at the given rate.
+// Deadlines are absolute, so the loop does not drift when an update takes time.
+void updateData(VehicleData& data, TripleBuffer<VehicleSnapshot>& channel, TelemetryStore& store,
+                WarningEngine& engine, WarningQueue& warnings, int rateHz,
+                SamplingStats& stats, const std::atomic<bool>& running) {
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::nanoseconds(1000000000LL / rateHz);
+    std::mt19937& gen = threadGenerator();
+
+    // Warnings are evaluated in batches of about 100 ms worth of samples (rateHz is at most 10 kHz,
+    // so a batch holds at most 1000 frames)
+    SampleBatch batch(store.signalCount(), static_cast<size_t>(std::max(1, rateHz / 10)));
+    std::vector<WarningEvent> events;
+    // Edges the display has not made room for yet: a lost clear edge would leave a warning latched,
+    // so they wait here (in order) instead of being dropped when the queue is full
+    std::deque<WarningEvent> pendingWarnings;
+    auto deadline = Clock::now();
+    while (running.load(std::memory_order_relaxed)) {
+        waitUntil(deadline);
+        auto woke = Clock::now();
+        stats.record(std::chrono::duration_cast<std::chrono::nanoseconds>(woke - deadline).count());
+
+        data.update(gen);  // Update the data (speed, fuel, temperature)
+        channel.publish(data.snapshot());
+
+        // Keep the history for trends and warnings
+        int64_t timestamp = telemetryNow();
+        store.append(kSpeedSignal, timestamp, static_cast<float>(data.speed));
+        store.append(kFuelSignal, timestamp, static_cast<float>(data.fuel));
+        store.append(kTemperatureSignal, timestamp, static_cast<float>(data.temperature));
+
+        size_t frame = batch.addFrame(timestamp);
+        batch.set(kSpeedSignal, frame, static_cast<float>(data.speed));
+        batch.set(kFuelSignal, frame, static_cast<float>(data.fuel));
+        batch.set(kTemperatureSignal, frame, static_cast<float>(data.temperature));
+        if (batch.full()) {
+            engine.evaluate(batch, events);
+            pendingWarnings.insert(pendingWarnings.end(), events.begin(), events.end());
+            events.clear();
+            batch.clear();
+        }
+        while (!pendingWarnings.empty() && warnings.push(pendingWarnings.front())) {
+            pendingWarnings.pop_front();
+        }
+
+        // Next deadline; if we fell more than a period behind, skip ahead instead of bursting
+        deadline += period;
+        auto now = Clock::now();
+        if (now - deadline > period) {
+            uint64_t missed = static_cast<uint64_t>((now - deadline) / period);
+            stats.missedDeadlines.fetch_add(missed, std::memory_order_relaxed);
+            deadline += missed * period;
+        }
+    }
+}
+
+// Print the achieved update rate and timing jitter of a simulation run
+void printSamplingReport(const SamplingStats& stats, int rateHz, double seconds) {
+    uint64_t updates = stats.updates.load();
+    std::cout << "\nRequested rate: " << rateHz << " Hz\n";
+    std::cout << "Achieved rate:  " << static_cast<int>(updates / seconds) << " Hz (" << updates << " updates in "
+              << seconds << " s)\n";
+    if (updates > 0) {
+        std::cout << "Jitter:         mean " << stats.totalLatenessNs.load() / updates / 1000.0 << " us, max "
+                  << stats.maxLatenessNs.load() / 1000.0 << " us late\n";
+    }
+    std::cout << "Missed deadlines: " << stats.missedDeadlines.load() << "\n";
+}
+
+// The previous design: one mutex shared by the updater and the display, held while rendering
+class LockedSnapshot {
+private:
+    std::mutex dataMutex;
+    VehicleSnapshot value;
+
+public:
+    explicit LockedSnapshot(const VehicleSnapshot& initial) : value(initial) {}
+
+    void publish(const VehicleSnapshot& snapshot) {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        value = snapshot;
+    }
+
+    template <typename Render>
+    void view(Render render) {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        render(value);
+    }
+};
+
+// Same interface for the triple buffer: rendering happens on the reader's private copy
+class TripleBufferChannel {
+private:
+    TripleBuffer<VehicleSnapshot> buffer;
+
+public:
+    explicit TripleBufferChannel(const VehicleSnapshot& initial) : buffer(initial) {}
+
+    void publish(const VehicleSnapshot& snapshot) {
+        buffer.publish(snapshot);
+    }
+
+    template <typename Render>
+    void view(Render render) {
+        render(buffer.read());
+    }
+};
+
+// Latency histogram with power-of-two nanosecond buckets
+struct LatencyHistogram {
+    static const int kBuckets = 32;
+    uint64_t counts[kBuckets] = {};
+    uint64_t total = 0;
+    uint64_t maxNs = 0;
+
+    void record(uint64_t ns) {
+        int bucket = 0;
+        while (bucket + 1 < kBuckets && (uint64_t(1) << (bucket + 1)) <= ns) {
+            bucket++;
+        }
+        counts[bucket]++;
+        total++;
+        maxNs = std::max(maxNs, ns);
+    }
+
+    // Upper bound of the bucket holding the given percentile
+    uint64_t percentile(double p) const {
+        uint64_t target = static_cast<uint64_t>(p * total);
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < kBuckets; ++bucket) {
+            seen += counts[bucket];
+            if (seen > target) {
+                return uint64_t(1) << (bucket + 1);
+            }
+        }
+        return maxNs;
+    }
+
+    void print(const std::string& title) const {
+        std::cout << title << ": p50 < " << percentile(0.50) << " ns, p99 < " << percentile(0.99)
+                  << " ns, p99.9 < " << percentile(0.999) << " ns, max " << maxNs << " ns\n";
+        for (int bucket = 0; bucket < kBuckets; ++bucket) {
+            if (counts[bucket] == 0) {
+                continue;
+            }
+            int bar = static_cast<int>(50 * counts[bucket] / total) + 1;
+            std::cout << "  < " << (uint64_t(1) << (bucket + 1)) << " ns\t" << counts[bucket] << "\t"
+                      << std::string(bar, '#') << "\n";
+        }
+    }
+};
+
+// Publish at a high rate while a reader renders slowly, and record how long each publish takes
+template <typename Channel>
+LatencyHistogram measurePublishLatency(int updates) {
+    using Clock = std::chrono::steady_clock;
+    Channel channel(VehicleSnapshot{0, 100, 80});
+    std::atomic<bool> done(false);
+    LatencyHistogram histogram;
+
+    // Reader: renders the snapshot to a slow terminal, where the write blocks for about 50 us
+    std::thread reader([&] {
+        std::string frame;
+        while (!done.load(std::memory_order_relaxed)) {
+            channel.view([&](const VehicleSnapshot& data) {
+                frame = "Speed: " + std::to_string(data.speed) + " Fuel: " + std::to_string(data.fuel);
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            });
+        }
+    });
+
+    // Writer: one update every 2 us (500 kHz)
+    for (int i = 0; i < updates; ++i) {
+        auto start = Clock::now();
+        channel.publish(VehicleSnapshot{i % 121, 100 - i % 100, 80 + i % 40});
+        auto end = Clock::now();
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        while (Clock::now() < end + std::chrono::microseconds(2)) {
         }
-        std::this_thread::sleep_for(std::chrono::seconds(1));  // Sleep for 1 second
     }
+    done = true;
+    reader.join();
+    return histogram;
 }
 
-int main() {
-    VehicleData data;  // Vehicle data object to hold the speed, fuel, and temperature
-    std::mutex dataMutex;  // Mutex to protect the shared data
+// Hammer the triple buffer and check that the reader never sees a torn snapshot
+void stressTripleBuffer(int updates) {
+    TripleBuffer<VehicleSnapshot> channel(VehicleSnapshot{0, 0, 0});
+    std::atomic<bool> done(false);
+    uint64_t reads = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+
+    std::thread reader([&] {
+        int last = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            const VehicleSnapshot& data = channel.read();
+            // The writer keeps fuel == -speed and temperature == 2 * speed
+            if (data.fuel != -data.speed || data.temperature != 2 * data.speed) {
+                torn++;
+            }
+            if (data.speed < last) {
+                backwards++;
+            }
+            last = data.speed;
+            reads++;
+        }
+    });
+
+    for (int i = 1; i <= updates; ++i) {
+        channel.publish(VehicleSnapshot{i, -i, 2 * i});
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    std::cout << "Stress test: " << updates << " updates, " << reads << " reads, " << torn
+              << " torn snapshots, " << backwards << " out-of-order reads\n";
+}
+
+// Append and window-query cost of the telemetry store with many signals
+void benchmarkTelemetryStore() {
+    using Clock = std::chrono::steady_clock;
+    const SignalId signals = 256;
+    const int samplesPerSignal = 40000;  // One sample per millisecond for 40 s
+    std::vector<std::string> names;
+    for (SignalId i = 0; i < signals; ++i) {
+        names.push_back("signal" + std::to_string(i));
+    }
+    TelemetryStore store(names, 16384);
+
+    std::mt19937& gen = threadGenerator();
+    std::uniform_real_distribution<float> valueDist(0.0f, 100.0f);
+    std::vector<float> samples(4096);
+    for (float& value : samples) {
+        value = valueDist(gen);
+    }
+
+    auto start = Clock::now();
+    for (int i = 0; i < samplesPerSignal; ++i) {
+        for (SignalId signal = 0; signal < signals; ++signal) {
+            store.append(signal, int64_t(i) * 1000000, samples[(i + signal) & 4095]);
+        }
+    }
+    double appendNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                      (double(samplesPerSignal) * signals);
+
+    // 1 s and 10 s windows ending at the newest sample
+    double checksum = 0;
+    const int64_t newest = int64_t(samplesPerSignal) * 1000000;
+    for (int64_t windowNs : {1000000000LL, 10000000000LL}) {
+        start = Clock::now();
+        for (int round = 0; round < 20; ++round) {
+            for (SignalId signal = 0; signal < signals; ++signal) {
+                checksum += store.query(signal, newest - windowNs, newest).mean;
+            }
+        }
+        double queryUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / (20.0 * signals);
+        std::cout << "Telemetry store: " << windowNs / 1000000 << " ms window query " << queryUs << " us\n";
+    }
+    std::cout << "Telemetry store: append " << appendNs << " ns per sample (" << signals << " signals)\n";
+    volatile double sink = checksum;
+    (void)sink;
+}
+
+// Batch evaluation cost of a large rule set
+void benchmarkWarningEngine() {
+    using Clock = std::chrono::steady_clock;
+    const SignalId signals = 256;
+    const int rules = 400;
+    const size_t frames = 1024;
+    std::mt19937& gen = threadGenerator();
+    std::uniform_real_distribution<float> valueDist(0.0f, 100.0f);
+
+    WarningEngine engine;
+    for (int i = 0; i < rules; ++i) {
+        float threshold = 90.0f + i % 10;
+        RuleCondition condition = (i % 2 == 0) ? RuleCondition::Above : RuleCondition::Below;
+        if (condition == RuleCondition::Below) {
+            threshold = 100.0f - threshold;
+        }
+        float clear = condition == RuleCondition::Above ? threshold - 5.0f : threshold + 5.0f;
+        engine.addRule({SignalId(i % signals), condition, threshold, clear, 3, "rule " + std::to_string(i)});
+    }
+    engine.compile();
+
+    SampleBatch batch(signals, frames);
+    for (size_t frame = 0; frame < frames; ++frame) {
+        batch.addFrame(int64_t(frame) * 1000000);
+        for (SignalId signal = 0; signal < signals; ++signal) {
+            batch.set(signal, frame, valueDist(gen));
+        }
+    }
+
+    std::vector<WarningEvent> events;
+    const int rounds = 50;
+    size_t eventCount = 0;
+    auto start = Clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        engine.evaluate(batch, events);
+        eventCount += events.size();
+        events.clear();
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (double(rounds) * rules * frames);
+    std::cout << "Warning engine: " << rules << " rules x " << frames << " samples, " << ns
+              << " ns per rule-sample, " << eventCount / rounds << " edges per batch\n";
+}
+
+void runBenchmark() {
+    benchmarkWarningEngine();
+    benchmarkTelemetryStore();
+    stressTripleBuffer(5000000);
+    const int updates = 500000;
+    measurePublishLatency<LockedSnapshot>(updates).print("Mutex publish latency");
+    measurePublishLatency<TripleBufferChannel>(updates).print("Triple buffer publish latency");
+}
+
+int main(int argc, char* argv[]) {
+    int rateHz = 1;        // Updates per second
+    int durationSeconds = 0;  // 0 = run until interrupted
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bench") {
+            runBenchmark();
+            return 0;
+        } else if (arg == "--rate" && i + 1 < argc) {
+            // High-rate simulation mode, e.g. --rate 5000 for CAN-bus-like update rates
+            rateHz = std::stoi(argv[++i]);
+            if (durationSeconds == 0) {
+                durationSeconds = 10;
+            }
+        } else if (arg == "--duration" && i + 1 < argc) {
+            durationSeconds = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--rate 1-10000 [--duration seconds] | --bench]\n";
+            return 1;
+        }
+    }
+    if (rateHz < 1 || rateHz > 10000) {
+        std::cerr << "The update rate must be between 1 and 10000 Hz.\n";
+        return 1;
+    }
+
+    VehicleData data;  // Vehicle data object to hold the speed, fuel, and temperature (owned by the updater)
+    TripleBuffer<VehicleSnapshot> channel(data.snapshot());  // Publishes snapshots to the display without locking
+    TelemetryStore store({"speed", "fuel", "temperature"}, std::max(1024, rateHz * 16));  // At least 16 s of history
+    WarningEngine engine;
+    addDashboardRules(engine);
+    WarningQueue warnings;  // Warning edges from the updater to the display
+    SamplingStats stats;
+    std::atomic<bool> running(true);
 
     // Create two threads: one to update the data, one to display the data
-    std::thread updateThread(updateData, std::ref(data), std::ref(dataMutex));
-    std::thread displayThread(displayData, std::ref(data), std::ref(dataMutex));
+    auto start = std::chrono::steady_clock::now();
+    std::thread updateThread(updateData, std::ref(data), std::ref(channel), std::ref(store), std::ref(engine),
+                             std::ref(warnings), rateHz, std::ref(stats), std::cref(running));
+    std::thread displayThread(displayData, std::ref(channel), std::cref(store), std::cref(engine), std::ref(warnings),
+                              std::cref(stats), std::cref(running));
 
-    // Wait for both threads to finish (they run infinitely in this case)
+    // Wait for both threads to finish (they run until the simulation ends, or forever by default)
+    if (durationSeconds > 0) {
+        std::this_thread::sleep_for(std::chrono::seconds(durationSeconds));
+        running = false;
+    }
     updateThread.join();
     displayThread.join();
 
+    if (durationSeconds > 0) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printSamplingReport(stats, rateHz, seconds);
+    }
     return 0;
-}
\ No newline at end of file
+}
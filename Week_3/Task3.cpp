@@ -1,114 +1,1342 @@
 #include <iostream>
-#include <queue>
-#include <cstdlib>
 #include <ctime>
 #include <chrono>
 #include <iomanip>
-#include <sstream>
+#include <cstdio>
+#include <type_traits>
 #include <thread>
+#include <atomic>
+#include <vector>
+#include <random>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <filesystem>
+#include <unistd.h>
 
-enum class EventType {
+enum class EventType : uint8_t {
     Tap,
-    Swipe
+    Swipe,
+    Rotate,     // Rotary encoder turned
+    Voice,      // Voice command recognized
+    LongPress,  // Finger held still
+    Pinch       // Two fingers moving apart or together
 };
 
-// Event class to represent a touchscreen event
+const int kEventTypeCount = 6;
+
+// Direction of a swipe
+enum class SwipeDirection : uint8_t {
+    None,
+    Up,
+    Down,
+    Left,
+    Right
+};
+
+const int kSwipeDirectionCount = 5;
+
+// Commands the voice recognizer reports, by the id carried in a voice event's x
+const char* const kVoiceCommands[] = {"Navigate home", "Call contact", "Play music", "Raise temperature"};
+const int kVoiceCommandCount = 4;
+
+// Event class to represent an input event.
+// Events are small trivially copyable records; the timestamp is a steady_clock reading in
+// nanoseconds and is only turned into text when the event is logged (see formatTimestamp).
 class Event {
 public:
-    Event(EventType type, int x, int y, std::string timestamp)
-        : eventType(type), xCoord(x), yCoord(y), timestamp(timestamp) {}
+    Event() = default;
+
+    Event(EventType type, int x, int y, int64_t timestampNs, float value = 0.0f,
+          SwipeDirection direction = SwipeDirection::None)
+        : timestampNs(timestampNs), xCoord(x), yCoord(y), value(value), eventType(type), direction(direction) {}
 
     EventType getEventType() const { return eventType; }
     int getX() const { return xCoord; }
     int getY() const { return yCoord; }
-    std::string getTimestamp() const { return timestamp; }
+    int64_t getTimestamp() const { return timestampNs; }
+    float getValue() const { return value; }
+    SwipeDirection getDirection() const { return direction; }
 
 private:
-    EventType eventType;
-    int xCoord;
-    int yCoord;
-    std::string timestamp;
+    int64_t timestampNs = 0;  // steady_clock time since epoch, in nanoseconds
+    int32_t xCoord = 0;       // For rotary events: detents turned; for voice events: command id
+    int32_t yCoord = 0;
+    float value = 0.0f;       // For swipes: velocity in px/s; for pinches: scale factor
+    EventType eventType = EventType::Tap;
+    SwipeDirection direction = SwipeDirection::None;
+};
+
+static_assert(std::is_trivially_copyable<Event>::value, "events are copied through the ring by value");
+static_assert(sizeof(Event) <= 32, "events should stay within half a cache line");
+
+// True if the event's enums and command id are in range: events read back from a trace file
+// are checked before anything uses them as table indexes
+bool isValidEvent(const Event& event) {
+    if (static_cast<int>(event.getEventType()) >= kEventTypeCount ||
+        static_cast<int>(event.getDirection()) >= kSwipeDirectionCount) {
+        return false;
+    }
+    return event.getEventType() != EventType::Voice || (event.getX() >= 0 && event.getX() < kVoiceCommandCount);
+}
+
+// Bounded lock-free ring buffer (after Dmitry Vyukov's bounded queue).
+// Every cell carries a sequence number telling producers and the consumer whose turn it is,
+// so pushes from several threads never take a lock. Any thread may also pop, which producers
+// use to drop the oldest event when the ring is full.
+template <typename T>
+class EventRing {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit EventRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    bool tryPush(const T& item) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = item;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& item) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    item = cell.data;
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
 };
 
-// Function to get the current timestamp in "HH:MM:SS" format
-std::string getCurrentTime() {
+// What a producer does when the ring is full
+enum class BackpressurePolicy {
+    Block,       // Wait until the dispatcher makes room
+    DropOldest,  // Discard the oldest queued event to make room
+    Coalesce     // Merge consecutive same-type events into one until there is room
+};
+
+// Producer side of the pipeline: one per input source (touch, rotary, voice)
+template <typename T>
+class EventProducer {
+private:
+    EventRing<T>& ring;
+    BackpressurePolicy policy;
+    T pending;              // Coalesce: merged event waiting for room in the ring
+    bool hasPending = false;
+
+public:
+    uint64_t dropped = 0;    // Events discarded by DropOldest
+    uint64_t coalesced = 0;  // Events merged into the pending one by Coalesce
+
+    EventProducer(EventRing<T>& eventRing, BackpressurePolicy backpressure) : ring(eventRing), policy(backpressure) {}
+
+    // Submit an event; merge(pending, event) folds the event into the pending one for Coalesce and
+    // returns false if the two cannot be merged
+    template <typename Merge>
+    void submit(const T& event, Merge merge) {
+        switch (policy) {
+            case BackpressurePolicy::Block:
+                while (!ring.tryPush(event)) {
+                    std::this_thread::yield();
+                }
+                break;
+
+            case BackpressurePolicy::DropOldest:
+                while (!ring.tryPush(event)) {
+                    T oldest;
+                    if (ring.tryPop(oldest)) {
+                        dropped++;
+                    }
+                }
+                break;
+
+            case BackpressurePolicy::Coalesce:
+                if (hasPending && ring.tryPush(pending)) {
+                    hasPending = false;
+                }
+                if (hasPending) {
+                    if (merge(pending, event)) {
+                        coalesced++;  // The ring is still full: the event was folded into the pending one
+                        return;
+                    }
+                    flush();
+                }
+                if (!ring.tryPush(event)) {
+                    pending = event;
+                    hasPending = true;
+                }
+                break;
+        }
+    }
+
+    void submit(const T& event) {
+        submit(event, [](T&, const T&) { return false; });
+    }
+
+    // Push the pending coalesced event, waiting for room if needed
+    void flush() {
+        while (hasPending && !ring.tryPush(pending)) {
+            std::this_thread::yield();
+        }
+        hasPending = false;
+    }
+};
+
+// Function to get the current event timestamp (monotonic, nanosecond resolution)
+int64_t getCurrentTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Function to format an event timestamp as "HH:MM:SS" local time.
+// The steady clock is mapped to wall-clock time through one reading of both clocks taken at start-up.
+std::string formatTimestamp(int64_t timestampNs) {
     using namespace std::chrono;
-    
-    // Get the current system time with high precision
-    auto now = high_resolution_clock::now();
-    auto time_point = system_clock::to_time_t(now);
-    
-    // Convert to tm struct
-    std::tm* tm_ptr = std::localtime(&time_point);
-    
-    // Create a string stream to format the time
-    std::stringstream ss;
-    ss << std::put_time(tm_ptr, "%H:%M:%S");
-    
-    return ss.str();
-}
-
-// Function to simulate the generation of random events
-Event generateRandomEvent() {
-    // Randomly decide whether it's a Tap or Swipe
-    EventType type = (rand() % 2 == 0) ? EventType::Tap : EventType::Swipe;
-
-    // Randomly generate coordinates (assuming screen size 800x600)
-    int x = rand() % 800;
-    int y = rand() % 600;
-
-    // Get the current timestamp
-    std::string timestamp = getCurrentTime();
-    
-    return Event(type, x, y, timestamp);
+    static const system_clock::time_point wallAnchor = system_clock::now();
+    static const int64_t steadyAnchor = getCurrentTime();
+
+    auto wallTime = wallAnchor + duration_cast<system_clock::duration>(nanoseconds(timestampNs - steadyAnchor));
+    std::time_t time_point = system_clock::to_time_t(wallTime);
+    std::tm tm_buf;
+    localtime_r(&time_point, &tm_buf);
+
+    char text[16];
+    std::snprintf(text, sizeof(text), "%02d:%02d:%02d", tm_buf.tm_hour, tm_buf.tm_min, tm_buf.tm_sec);
+    return text;
+}
+
+// Phase of a raw touch sample
+enum class TouchPhase : uint8_t {
+    Down,
+    Move,
+    Up
+};
+
+// One raw sample from the touch controller (one finger)
+struct TouchSample {
+    int64_t timestampNs;
+    float x;
+    float y;
+    uint8_t pointerId;
+    TouchPhase phase;
+};
+
+// Streaming gesture recognizer. It turns raw touch samples into Tap, Swipe, LongPress and Pinch
+// events as they arrive, keeping a fixed-size state per finger: nothing is buffered and nothing
+// is allocated per sample.
+class GestureRecognizer {
+public:
+    static const int kMaxPointers = 10;
+
+private:
+    static constexpr float kTouchSlop = 12.0f;               // Movement (px) still counted as a tap or hold
+    static constexpr int64_t kLongPressNs = 500000000;       // Hold time for a long press
+    static constexpr float kSwipeMinDistance = 40.0f;        // px
+    static constexpr float kSwipeMinVelocity = 250.0f;       // px/s
+    static constexpr float kPinchScaleStep = 0.1f;           // Report a pinch every 10% of scale change
+    static constexpr float kVelocitySmoothing = 0.5f;        // Weight of the newest sample in the velocity
+
+    struct Pointer {
+        bool active;
+        bool moved;           // Left the touch slop
+        bool longPressSent;
+        bool inPinch;         // Part of a two-finger gesture: no tap or swipe on release
+        int64_t downNs;
+        int64_t lastNs;
+        float downX, downY;
+        float x, y;
+        float vx, vy;         // Smoothed velocity, px/s
+    };
+
+    Pointer pointers[kMaxPointers] = {};
+    int activeCount = 0;
+    int pinchA = -1;          // The two fingers of the current pinch
+    int pinchB = -1;
+    float pinchStartDistance = 0.0f;
+    float lastPinchScale = 1.0f;
+
+    static float distance(float x1, float y1, float x2, float y2) {
+        return std::sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
+    }
+
+    template <typename Emit>
+    void checkLongPress(Pointer& p, int64_t nowNs, Emit& emit) {
+        if (!p.moved && !p.longPressSent && !p.inPinch && nowNs - p.downNs >= kLongPressNs) {
+            p.longPressSent = true;
+            emit(Event(EventType::LongPress, static_cast<int>(p.x), static_cast<int>(p.y), nowNs));
+        }
+    }
+
+    template <typename Emit>
+    void updatePinch(int64_t nowNs, Emit& emit) {
+        const Pointer& a = pointers[pinchA];
+        const Pointer& b = pointers[pinchB];
+        float scale = distance(a.x, a.y, b.x, b.y) / pinchStartDistance;
+        if (std::fabs(scale - lastPinchScale) >= kPinchScaleStep) {
+            lastPinchScale = scale;
+            emit(Event(EventType::Pinch, static_cast<int>((a.x + b.x) / 2), static_cast<int>((a.y + b.y) / 2), nowNs,
+                       scale));
+        }
+    }
+
+public:
+    // Feed one raw sample; recognized gestures are passed to emit(const Event&)
+    template <typename Emit>
+    void process(const TouchSample& sample, Emit emit) {
+        if (sample.pointerId >= kMaxPointers) {
+            return;
+        }
+        Pointer& p = pointers[sample.pointerId];
+
+        if (sample.phase == TouchPhase::Down) {
+            if (p.active) {
+                return;  // Repeated Down for a finger already down: counting it again would fake a second finger
+            }
+            p = Pointer{true, false, false, false, sample.timestampNs, sample.timestampNs,
+                        sample.x, sample.y, sample.x, sample.y, 0.0f, 0.0f};
+            activeCount++;
+
+            // A second finger starts a pinch
+            if (activeCount == 2 && pinchA < 0) {
+                for (int i = 0; i < kMaxPointers; ++i) {
+                    if (pointers[i].active && i != sample.pointerId) {
+                        pinchA = i;
+                    }
+                }
+                pinchB = sample.pointerId;
+                pinchStartDistance = std::max(1.0f, distance(pointers[pinchA].x, pointers[pinchA].y, p.x, p.y));
+                lastPinchScale = 1.0f;
+                pointers[pinchA].inPinch = true;
+                p.inPinch = true;
+            }
+            return;
+        }
+
+        if (!p.active) {
+            return;  // Move or Up without a Down
+        }
+
+        // Track position and smoothed velocity
+        int64_t dtNs = sample.timestampNs - p.lastNs;
+        if (dtNs > 0) {
+            float vx = (sample.x - p.x) * 1e9f / dtNs;
+            float vy = (sample.y - p.y) * 1e9f / dtNs;
+            p.vx = kVelocitySmoothing * vx + (1.0f - kVelocitySmoothing) * p.vx;
+            p.vy = kVelocitySmoothing * vy + (1.0f - kVelocitySmoothing) * p.vy;
+        }
+        p.x = sample.x;
+        p.y = sample.y;
+        p.lastNs = sample.timestampNs;
+        if (!p.moved && distance(p.downX, p.downY, p.x, p.y) > kTouchSlop) {
+            p.moved = true;
+        }
+
+        if (sample.phase == TouchPhase::Move) {
+            if (pinchA >= 0 && (sample.pointerId == pinchA || sample.pointerId == pinchB)) {
+                updatePinch(sample.timestampNs, emit);
+            }
+            checkLongPress(p, sample.timestampNs, emit);
+            return;
+        }
+
+        // Finger lifted
+        p.active = false;
+        activeCount--;
+        if (sample.pointerId == pinchA || sample.pointerId == pinchB) {
+            pinchA = pinchB = -1;  // The pinch ends with its first finger
+        }
+        if (p.inPinch || p.longPressSent) {
+            return;
+        }
+        int64_t durationNs = sample.timestampNs - p.downNs;
+        if (!p.moved) {
+            if (durationNs < kLongPressNs) {
+                emit(Event(EventType::Tap, static_cast<int>(p.x), static_cast<int>(p.y), sample.timestampNs));
+            } else {
+                checkLongPress(p, sample.timestampNs, emit);
+            }
+            return;
+        }
+
+        float dx = p.x - p.downX;
+        float dy = p.y - p.downY;
+        float speed = std::sqrt(p.vx * p.vx + p.vy * p.vy);
+        if (distance(0, 0, dx, dy) >= kSwipeMinDistance && speed >= kSwipeMinVelocity) {
+            SwipeDirection direction;
+            if (std::fabs(dx) > std::fabs(dy)) {
+                direction = dx > 0 ? SwipeDirection::Right : SwipeDirection::Left;
+            } else {
+                direction = dy > 0 ? SwipeDirection::Down : SwipeDirection::Up;
+            }
+            emit(Event(EventType::Swipe, static_cast<int>(p.downX), static_cast<int>(p.downY), sample.timestampNs,
+                       speed, direction));
+        }
+    }
+
+    // Report long presses of fingers that are held still (no samples arrive while nothing moves)
+    template <typename Emit>
+    void tick(int64_t nowNs, Emit emit) {
+        for (Pointer& p : pointers) {
+            if (p.active) {
+                checkLongPress(p, nowNs, emit);
+            }
+        }
+    }
+};
+
+// Kinds of simulated touch gestures
+enum class GestureKind {
+    Tap,
+    Swipe,
+    LongPress,
+    Pinch
+};
+
+// Generate the raw 240 Hz touch samples of a simulated gesture starting at startNs
+void simulateGesture(GestureKind kind, std::mt19937& gen, int64_t startNs, std::vector<TouchSample>& samples) {
+    const int64_t frameNs = 1000000000LL / 240;
+    std::uniform_real_distribution<float> xDist(100.0f, 700.0f);
+    std::uniform_real_distribution<float> yDist(100.0f, 500.0f);
+    std::uniform_real_distribution<float> jitter(-1.5f, 1.5f);
+    float x = xDist(gen);
+    float y = yDist(gen);
+    int64_t t = startNs;
+    auto add = [&](uint8_t pointer, TouchPhase phase, float px, float py) {
+        samples.push_back({t, px, py, pointer, phase});
+    };
+
+    switch (kind) {
+        case GestureKind::Tap:
+        case GestureKind::LongPress: {
+            int frames = kind == GestureKind::Tap ? 20 : 170;  // About 80 ms or 700 ms
+            add(0, TouchPhase::Down, x, y);
+            for (int i = 0; i < frames; ++i) {
+                t += frameNs;
+                add(0, TouchPhase::Move, x + jitter(gen), y + jitter(gen));
+            }
+            t += frameNs;
+            add(0, TouchPhase::Up, x, y);
+            break;
+        }
+
+        case GestureKind::Swipe: {
+            // About 300 px in 150 ms along a random axis
+            const float step = 300.0f / 36;
+            int direction = static_cast<int>(gen() % 4);
+            float dx = direction == 2 ? -step : direction == 3 ? step : 0.0f;
+            float dy = direction == 0 ? -step : direction == 1 ? step : 0.0f;
+            add(0, TouchPhase::Down, x, y);
+            for (int i = 0; i < 36; ++i) {
+                t += frameNs;
+                x += dx;
+                y += dy;
+                add(0, TouchPhase::Move, x, y);
+            }
+            add(0, TouchPhase::Up, x, y);
+            break;
+        }
+
+        case GestureKind::Pinch: {
+            // Two fingers moving apart (zoom in) over 300 ms
+            float spread = 40.0f;
+            add(0, TouchPhase::Down, x - spread, y);
+            add(1, TouchPhase::Down, x + spread, y);
+            for (int i = 0; i < 72; ++i) {
+                t += frameNs;
+                spread += 0.5f;
+                add(0, TouchPhase::Move, x - spread, y);
+                add(1, TouchPhase::Move, x + spread, y);
+            }
+            t += frameNs;
+            add(0, TouchPhase::Up, x - spread, y);
+            add(1, TouchPhase::Up, x + spread, y);
+            break;
+        }
+    }
 }
 
+
 // Function to process the Tap event
 void handleTapEvent(const Event& event) {
-    std::cout << "Tap event detected at position (" << event.getX() << ", " << event.getY() << ") at time " << event.getTimestamp() << std::endl;
+    std::cout << "Tap event detected at position (" << event.getX() << ", " << event.getY() << ") at time " << formatTimestamp(event.getTimestamp()) << std::endl;
 }
 
-// Function to process the Swipe event
+// Function to process the Swipe event (direction and velocity come from the gesture recognizer)
 void handleSwipeEvent(const Event& event) {
-    // For swipe, we assume there is some direction calculation based on consecutive events
-    // In this simulation, we will generate a random direction for simplicity.
-    const char* directions[] = {"Up", "Down", "Left", "Right"};
-    int dir = rand() % 4;
+    const char* directions[] = {"None", "Up", "Down", "Left", "Right"};
+    int direction = static_cast<int>(event.getDirection());
+    std::cout << "Swipe event detected in direction: " << (direction < kSwipeDirectionCount ? directions[direction] : "Unknown")
+              << " at " << static_cast<int>(event.getValue()) << " px/s from position ("
+              << event.getX() << ", " << event.getY() << ") at time " << formatTimestamp(event.getTimestamp()) << std::endl;
+}
+
+// Function to process the LongPress event
+void handleLongPressEvent(const Event& event) {
+    std::cout << "Long press detected at position (" << event.getX() << ", " << event.getY() << ") at time "
+              << formatTimestamp(event.getTimestamp()) << std::endl;
+}
+
+// Function to process the Pinch event
+void handlePinchEvent(const Event& event) {
+    std::cout << "Pinch detected around (" << event.getX() << ", " << event.getY() << "), zoom "
+              << static_cast<int>(event.getValue() * 100) << "% at time " << formatTimestamp(event.getTimestamp()) << std::endl;
+}
+
+// Function to process the Rotate event
+void handleRotateEvent(const Event& event) {
+    std::cout << "Rotary encoder turned by " << event.getX() << " detents at time " << formatTimestamp(event.getTimestamp()) << std::endl;
+}
+
+// Function to process the Voice event
+void handleVoiceEvent(const Event& event) {
+    int command = event.getX();
+    std::cout << "Voice command \"" << (command >= 0 && command < kVoiceCommandCount ? kVoiceCommands[command] : "Unknown")
+              << "\" recognized at time " << formatTimestamp(event.getTimestamp()) << std::endl;
+}
+
+// Screen rectangle a handler listens to (screen size 800x600)
+struct ScreenRegion {
+    int x;
+    int y;
+    int width;
+    int height;
+
+    bool contains(int px, int py) const {
+        return px >= x && px < x + width && py >= y && py < y + height;
+    }
+};
+
+// Event dispatcher: components register handlers per event type, either for the whole screen
+// or for a screen region. Lookup goes through a jump table indexed by event type, and region
+// handlers are found through a coarse grid over the screen, so hit-testing costs one cell
+// lookup instead of a scan over every widget.
+//
+// The tables live in an immutable snapshot. Adding or removing a handler builds a new snapshot
+// and publishes it; the dispatching thread picks it up before its next event, so registration
+// never pauses dispatch and a handler being removed stays alive until the dispatcher lets go of
+// the old snapshot. dispatch() must be called from a single thread.
+class EventDispatcher {
+public:
+    using Handler = std::function<void(const Event&)>;
+
+    static const int kScreenWidth = 800;
+    static const int kScreenHeight = 600;
+
+private:
+    static const int kEventTypes = kEventTypeCount;
+    static const int kCellSize = 50;
+    static const int kGridColumns = kScreenWidth / kCellSize;
+    static const int kGridRows = kScreenHeight / kCellSize;
+
+    struct Registration {
+        int id;
+        EventType type;
+        bool hasRegion;
+        ScreenRegion region;
+        Handler handler;
+    };
+
+    struct Snapshot {
+        std::vector<Registration> registrations;             // In registration order
+        std::vector<uint32_t> global[kEventTypes];           // Whole-screen handlers per type
+        // Region handlers per (type, cell), flattened: entries of (type, cell) are
+        // cellEntries[cellStart[i] .. cellStart[i + 1]) with i = type * cells + cell
+        std::vector<uint32_t> cellStart;
+        std::vector<uint32_t> cellEntries;
+    };
+
+    std::mutex writerMutex;                      // Serializes add/remove
+    std::vector<Registration> registrations;     // Writer-side copy of the current registrations
+    int nextId = 1;
+    std::shared_ptr<const Snapshot> published;   // Accessed with std::atomic_load/atomic_store
+    std::atomic<uint64_t> version{0};
+
+    // Dispatcher-thread cache of the published snapshot
+    std::shared_ptr<const Snapshot> current;
+    uint64_t currentVersion = ~0ULL;
+
+    static bool hasPosition(EventType type) {
+        return type != EventType::Rotate && type != EventType::Voice;
+    }
+
+    static int typeIndex(EventType type) {
+        return static_cast<int>(type);
+    }
+
+    static int cellOf(int x, int y) {
+        return (y / kCellSize) * kGridColumns + x / kCellSize;
+    }
+
+    // Build the lookup tables for the current registrations and publish them
+    void publish() {
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->registrations = registrations;
+
+        const int cells = kGridColumns * kGridRows;
+        std::vector<uint32_t> counts(kEventTypes * cells + 1, 0);
+        for (uint32_t i = 0; i < registrations.size(); ++i) {
+            const Registration& r = registrations[i];
+            if (!r.hasRegion) {
+                snapshot->global[typeIndex(r.type)].push_back(i);
+                continue;
+            }
+            for (int row = r.region.y / kCellSize; row <= (r.region.y + r.region.height - 1) / kCellSize; ++row) {
+                for (int col = r.region.x / kCellSize; col <= (r.region.x + r.region.width - 1) / kCellSize; ++col) {
+                    counts[typeIndex(r.type) * cells + row * kGridColumns + col + 1]++;
+                }
+            }
+        }
+        for (size_t i = 1; i < counts.size(); ++i) {
+            counts[i] += counts[i - 1];
+        }
+        snapshot->cellStart = counts;
+        snapshot->cellEntries.resize(counts.back());
+        for (uint32_t i = 0; i < registrations.size(); ++i) {
+            const Registration& r = registrations[i];
+            if (!r.hasRegion) {
+                continue;
+            }
+            for (int row = r.region.y / kCellSize; row <= (r.region.y + r.region.height - 1) / kCellSize; ++row) {
+                for (int col = r.region.x / kCellSize; col <= (r.region.x + r.region.width - 1) / kCellSize; ++col) {
+                    snapshot->cellEntries[counts[typeIndex(r.type) * cells + row * kGridColumns + col]++] = i;
+                }
+            }
+        }
+
+        std::atomic_store(&published, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+        version.fetch_add(1, std::memory_order_release);
+    }
+
+    int add(EventType type, bool hasRegion, ScreenRegion region, Handler handler) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        int id = nextId++;
+        registrations.push_back(Registration{id, type, hasRegion, region, std::move(handler)});
+        publish();
+        return id;
+    }
+
+public:
+    EventDispatcher() {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        publish();
+    }
+
+    // Register a handler for every event of a type; returns its id for removeHandler
+    int addHandler(EventType type, Handler handler) {
+        return add(type, false, ScreenRegion{0, 0, kScreenWidth, kScreenHeight}, std::move(handler));
+    }
+
+    // Register a handler for events of a type inside a screen region. When regions overlap, the
+    // most recently registered one (the topmost widget) receives the event.
+    int addHandler(EventType type, ScreenRegion region, Handler handler) {
+        if (!hasPosition(type)) {
+            throw std::invalid_argument("rotary and voice events have no screen position");
+        }
+        int x1 = std::max(region.x, 0);
+        int y1 = std::max(region.y, 0);
+        int x2 = std::min(region.x + region.width, static_cast<int>(kScreenWidth));
+        int y2 = std::min(region.y + region.height, static_cast<int>(kScreenHeight));
+        if (x1 >= x2 || y1 >= y2) {
+            throw std::invalid_argument("handler region lies outside the screen");
+        }
+        return add(type, true, ScreenRegion{x1, y1, x2 - x1, y2 - y1}, std::move(handler));
+    }
+
+    // Unregister a handler; returns false if the id is unknown
+    bool removeHandler(int id) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        auto it = std::find_if(registrations.begin(), registrations.end(),
+                               [id](const Registration& r) { return r.id == id; });
+        if (it == registrations.end()) {
+            return false;
+        }
+        registrations.erase(it);
+        publish();
+        return true;
+    }
+
+    // Deliver an event to the whole-screen handlers of its type, then to the topmost region
+    // handler under it. Returns the number of handlers called.
+    int dispatch(const Event& event) {
+        uint64_t latest = version.load(std::memory_order_acquire);
+        if (latest != currentVersion) {
+            currentVersion = latest;
+            current = std::atomic_load(&published);
+        }
+        const Snapshot& snapshot = *current;
+        const int type = typeIndex(event.getEventType());
+        if (type >= kEventTypes) {
+            return 0;  // Not a known event type: nothing can be registered for it
+        }
+        int called = 0;
+
+        for (uint32_t index : snapshot.global[type]) {
+            snapshot.registrations[index].handler(event);
+            called++;
+        }
+
+        if (hasPosition(event.getEventType())) {
+            int x = event.getX();
+            int y = event.getY();
+            if (x >= 0 && x < kScreenWidth && y >= 0 && y < kScreenHeight) {
+                int cell = type * kGridColumns * kGridRows + cellOf(x, y);
+                // Entries are in registration order: the last one containing the point is on top
+                for (uint32_t i = snapshot.cellStart[cell + 1]; i > snapshot.cellStart[cell]; --i) {
+                    const Registration& r = snapshot.registrations[snapshot.cellEntries[i - 1]];
+                    if (r.region.contains(x, y)) {
+                        r.handler(event);
+                        called++;
+                        break;
+                    }
+                }
+            }
+        }
+
+        return called;
+    }
+};
+
+// Binary trace file: a TraceHeader followed by raw Event records in dispatch order
+struct TraceHeader {
+    char magic[4];      // "EVTR"
+    uint32_t version;
+    uint32_t eventSize; // sizeof(Event) of the recording build
+    uint32_t reserved;
+};
+
+static const uint32_t kTraceVersion = 1;
+
+// Appends events to a binary trace file. record() only copies the event into a ring; a
+// background writer drains the ring and writes it out in large batches, so recording costs
+// the dispatcher a ring push rather than a file write.
+class TraceRecorder {
+private:
+    static const size_t kBatchEvents = 4096;
+
+    FILE* file;
+    EventRing<Event> ring;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> failed{false};
+    std::atomic<uint64_t> written{0};
+    std::thread writer;
+
+    // Stop the writer and close the file, each at most once; false if anything failed to write
+    bool finish() {
+        stopping = true;
+        if (writer.joinable()) {
+            writer.join();
+        }
+        if (file) {
+            if (std::fclose(file) != 0) {
+                failed = true;
+            }
+            file = nullptr;
+        }
+        return !failed.load();
+    }
+
+    void writeLoop() {
+        std::vector<Event> batch(kBatchEvents);
+        while (true) {
+            size_t count = 0;
+            while (count < kBatchEvents && ring.tryPop(batch[count])) {
+                count++;
+            }
+            if (count > 0) {
+                if (std::fwrite(batch.data(), sizeof(Event), count, file) != count) {
+                    failed = true;
+                }
+                written += count;
+            }
+            if (count < kBatchEvents) {
+                if (stopping.load()) {
+                    if (!ring.tryPop(batch[0])) {
+                        break;
+                    }
+                    if (std::fwrite(batch.data(), sizeof(Event), 1, file) != 1) {
+                        failed = true;
+                    }
+                    written++;
+                    continue;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));  // Let a batch accumulate
+            }
+        }
+    }
+
+public:
+    explicit TraceRecorder(const std::string& path, size_t capacity = 1 << 16) : ring(capacity) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            throw std::runtime_error("cannot create trace file " + path);
+        }
+        TraceHeader header{{'E', 'V', 'T', 'R'}, kTraceVersion, sizeof(Event), 0};
+        if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+            std::fclose(file);
+            throw std::runtime_error("cannot write trace file " + path);
+        }
+        writer = std::thread(&TraceRecorder::writeLoop, this);
+    }
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    ~TraceRecorder() {
+        finish();
+    }
+
+    // Queue an event for writing; waits for the writer rather than losing events
+    void record(const Event& event) {
+        while (!ring.tryPush(event)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Write out everything recorded so far and close the file; returns the number of events.
+    // Calling it again (or destroying the recorder afterwards) does nothing more.
+    uint64_t close() {
+        if (!finish()) {
+            throw std::runtime_error("writing the trace file failed");
+        }
+        return written.load();
+    }
+};
+
+// Result of replaying a trace
+struct ReplayStats {
+    uint64_t events = 0;
+    double seconds = 0.0;
+    int64_t maxLagNs = 0;  // Worst delay behind the recorded schedule
+    uint64_t corrupt = 0;  // Records with an out-of-range type, direction or command, skipped
+};
+
+// Stream a trace file back through the dispatcher. speed scales the recorded gaps between
+// events (2 = twice as fast); 0 replays as fast as possible. Events are re-stamped with the
+// time they are dispatched, so handlers see current timestamps. A partial record at the end
+// of the file (a recording that was cut off) is ignored, and records that fail isValidEvent are
+// counted as corrupt and skipped.
+ReplayStats replayTrace(const std::string& path, EventDispatcher& dispatcher, double speed) {
+    std::unique_ptr<FILE, int (*)(FILE*)> file(std::fopen(path.c_str(), "rb"), std::fclose);
+    if (!file) {
+        throw std::runtime_error("cannot open trace file " + path);
+    }
+    TraceHeader header;
+    if (std::fread(&header, sizeof(header), 1, file.get()) != 1 || std::string(header.magic, 4) != "EVTR" ||
+        header.version != kTraceVersion) {
+        throw std::runtime_error(path + " is not an event trace");
+    }
+    if (header.eventSize != sizeof(Event)) {
+        throw std::runtime_error(path + " was recorded with a different event layout");
+    }
+
+    ReplayStats stats;
+    std::vector<Event> batch(4096);
+    int64_t firstRecorded = 0;
+    int64_t replayStart = getCurrentTime();
+    size_t count;
+    while ((count = std::fread(batch.data(), sizeof(Event), batch.size(), file.get())) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            const Event& recorded = batch[i];
+            if (!isValidEvent(recorded)) {
+                stats.corrupt++;
+                continue;
+            }
+            if (stats.events == 0) {
+                firstRecorded = recorded.getTimestamp();
+            }
+            int64_t now = getCurrentTime();
+            if (speed > 0) {
+                int64_t due = replayStart + static_cast<int64_t>((recorded.getTimestamp() - firstRecorded) / speed);
+                if (due > now) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(due - now));
+                    now = getCurrentTime();
+                }
+                stats.maxLagNs = std::max(stats.maxLagNs, now - due);
+            }
+            dispatcher.dispatch(Event(recorded.getEventType(), recorded.getX(), recorded.getY(), now,
+                                      recorded.getValue(), recorded.getDirection()));
+            stats.events++;
+        }
+    }
+    stats.seconds = (getCurrentTime() - replayStart) / 1e9;
+    return stats;
+}
+
+// Rotary turns may be merged: x holds relative detents, so the merged event carries their sum
+// (and the newer timestamp); no turn is lost when the dispatcher falls behind
+bool mergeRotations(Event& pending, const Event& next) {
+    if (pending.getEventType() != EventType::Rotate || next.getEventType() != EventType::Rotate) {
+        return false;
+    }
+    pending = Event(EventType::Rotate, pending.getX() + next.getX(), next.getY(), next.getTimestamp(),
+                    next.getValue(), next.getDirection());
+    return true;
+}
+
+// Wait briefly for new events: spin first, then yield the CPU
+void backoff(int& idleRounds) {
+    if (++idleRounds < 64) {
+        return;
+    }
+    if (idleRounds < 128) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+// Enqueue-to-handle latency and throughput of the pipeline for one backpressure policy.
+// Each event carries its producer in x and its sequence number in y.
+void benchmarkPipeline(BackpressurePolicy policy, const char* name, int producers, int eventsPerProducer) {
+    using Clock = std::chrono::steady_clock;
+    EventRing<Event> ring(4096);
+    std::atomic<int> running(producers);
+    std::vector<uint64_t> dropped(producers, 0);
+    std::vector<uint64_t> coalesced(producers, 0);
+    std::vector<int64_t> latencies;
+    latencies.reserve(size_t(producers) * eventsPerProducer);
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            EventProducer<Event> producer(ring, policy);
+            for (int i = 0; i < eventsPerProducer; ++i) {
+                producer.submit(Event(EventType::Tap, p, i, getCurrentTime()), [](Event& pending, const Event& next) {
+                    if (pending.getX() != next.getX()) {
+                        return false;
+                    }
+                    pending = next;  // Taps of one producer: keep the newest
+                    return true;
+                });
+            }
+            producer.flush();
+            dropped[p] = producer.dropped;
+            coalesced[p] = producer.coalesced;
+            running.fetch_sub(1);
+        });
+    }
+
+    // Dispatcher: consume until every producer is done and the ring is empty
+    Event event;
+    int idleRounds = 0;
+    while (true) {
+        if (ring.tryPop(event)) {
+            latencies.push_back(getCurrentTime() - event.getTimestamp());
+            idleRounds = 0;
+        } else if (running.load() == 0) {
+            if (!ring.tryPop(event)) {
+                break;
+            }
+            latencies.push_back(getCurrentTime() - event.getTimestamp());
+        } else {
+            backoff(idleRounds);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    uint64_t totalDropped = 0, totalCoalesced = 0;
+    for (int p = 0; p < producers; ++p) {
+        totalDropped += dropped[p];
+        totalCoalesced += coalesced[p];
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double q) { return latencies.empty() ? 0 : latencies[size_t(q * (latencies.size() - 1))]; };
+    std::cout << std::left << std::setw(11) << name << std::right << " handled " << latencies.size() << " events, "
+              << static_cast<uint64_t>(latencies.size() / seconds / 1000) << "k events/s, latency p50 "
+              << percentile(0.5) / 1000.0 << " us, p99 " << percentile(0.99) / 1000.0 << " us, dropped "
+              << totalDropped << ", coalesced " << totalCoalesced << "\n";
+}
+
+// A fast rotary encoder feeding a small ring through a slow dispatcher: Coalesce must merge turns
+// without losing any detents
+void benchmarkRotaryCoalescing() {
+    const int turns = 1000000;
+    EventRing<Event> ring(64);
+    std::atomic<bool> done(false);
+    int64_t detentsIn = 0;
+    uint64_t coalesced = 0;
 
-    std::cout << "Swipe event detected in direction: " << directions[dir] << " at position (" 
-              << event.getX() << ", " << event.getY() << ") at time " << event.getTimestamp() << std::endl;
+    std::thread rotary([&] {
+        std::mt19937 gen(7);
+        EventProducer<Event> producer(ring, BackpressurePolicy::Coalesce);
+        for (int i = 0; i < turns; ++i) {
+            int detents = static_cast<int>(gen() % 5) - 2;
+            detentsIn += detents;
+            producer.submit(Event(EventType::Rotate, detents, 0, getCurrentTime()), mergeRotations);
+        }
+        producer.flush();
+        coalesced = producer.coalesced;
+        done.store(true);
+    });
+
+    int64_t detentsOut = 0;
+    uint64_t delivered = 0;
+    Event event;
+    while (true) {
+        if (ring.tryPop(event)) {
+            detentsOut += event.getX();
+            delivered++;
+            if (delivered % 16 == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));  // The dispatcher falls behind
+            }
+        } else if (done.load()) {
+            if (!ring.tryPop(event)) {
+                break;
+            }
+            detentsOut += event.getX();
+            delivered++;
+        }
+    }
+    rotary.join();
+    std::cout << "Rotary coalescing: " << turns << " turns delivered as " << delivered << " events (" << coalesced
+              << " merged), detents in " << detentsIn << ", out " << detentsOut
+              << (detentsIn == detentsOut && delivered + coalesced == turns ? "" : " (MISMATCH)") << "\n";
 }
 
-int main() {
-    // Initialize random seed
-    srand(static_cast<unsigned int>(time(0)));
+// Cost of creating an event, and of formatting its timestamp when it is logged
+void benchmarkEventCreation() {
+    using Clock = std::chrono::steady_clock;
+    const int events = 1000000;
+    std::mt19937 gen(42);
+    int64_t checksum = 0;
 
-    // Event queue
-    std::queue<Event> eventQueue;
+    auto start = Clock::now();
+    for (int i = 0; i < events; ++i) {
+        Event event(EventType::Tap, static_cast<int>(gen() % 800), static_cast<int>(gen() % 600), getCurrentTime());
+        checksum += event.getTimestamp();
+    }
+    double createNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / events;
 
-    // Simulate event generation and processing
-    const int numEvents = 10; // Generate 10 random events
+    start = Clock::now();
+    for (int i = 0; i < events / 10; ++i) {
+        checksum += static_cast<int64_t>(formatTimestamp(getCurrentTime()).size());
+    }
+    double formatNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (events / 10);
+
+    std::cout << "Event: " << sizeof(Event) << " bytes, created in " << createNs << " ns; formatting a timestamp for the log takes "
+              << formatNs << " ns\n";
+    volatile int64_t sink = checksum;
+    (void)sink;
+}
 
-    // Generate random events and enqueue them
-    for (int i = 0; i < numEvents; ++i) {
-        eventQueue.push(generateRandomEvent());
+// Hit-testing cost of the dispatcher against a linear scan over every widget, with another
+// thread adding and removing a handler while events are dispatched
+void benchmarkDispatcher() {
+    using Clock = std::chrono::steady_clock;
+    const int widgets = 200;
+    const int events = 1000000;
+    std::mt19937 gen(42);
 
-        // Small delay to simulate real-time event generation
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Delay for 100 milliseconds
+    EventDispatcher dispatcher;
+    std::vector<ScreenRegion> regions;
+    uint64_t hits = 0;
+    for (int i = 0; i < widgets; ++i) {
+        ScreenRegion region{static_cast<int>(gen() % 760), static_cast<int>(gen() % 560),
+                            40 + static_cast<int>(gen() % 80), 40 + static_cast<int>(gen() % 80)};
+        regions.push_back(region);
+        dispatcher.addHandler(EventType::Tap, region, [&hits, i](const Event&) { hits += i; });
+    }
+    std::vector<Event> taps;
+    for (int i = 0; i < events; ++i) {
+        taps.push_back(Event(EventType::Tap, static_cast<int>(gen() % 800), static_cast<int>(gen() % 600), 0));
     }
 
-    // Process the events in the queue
-    while (!eventQueue.empty()) {
-        Event currentEvent = eventQueue.front();
-        eventQueue.pop();
+    // Baseline: test every widget, topmost first
+    uint64_t scanHits = 0;
+    auto start = Clock::now();
+    for (const Event& tap : taps) {
+        for (int i = widgets - 1; i >= 0; --i) {
+            if (regions[i].contains(tap.getX(), tap.getY())) {
+                scanHits += i;
+                break;
+            }
+        }
+    }
+    double scanNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / events;
+
+    std::atomic<bool> running(true);
+    int republished = 0;
+    std::thread registrar([&] {
+        while (running.load()) {
+            int id = dispatcher.addHandler(EventType::Swipe, [](const Event&) {});
+            dispatcher.removeHandler(id);
+            republished += 2;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    start = Clock::now();
+    for (const Event& tap : taps) {
+        dispatcher.dispatch(tap);
+    }
+    double gridNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / events;
+    running = false;
+    registrar.join();
+
+    std::cout << "Dispatch to " << widgets << " tap widgets: grid " << gridNs << " ns per event, linear scan " << scanNs
+              << " ns per event (" << republished << " handler changes during dispatch"
+              << (hits == scanHits ? "" : ", MISMATCH") << ")\n";
+}
+
+// Recording cost per event and replay throughput of a trace of two million events
+void benchmarkTrace() {
+    using Clock = std::chrono::steady_clock;
+    // In the temp directory, unique per process, so the bench never writes into the working directory
+    std::string path =
+        (std::filesystem::temp_directory_path() / ("bench_trace_" + std::to_string(::getpid()) + ".evt")).string();
+    const int events = 2000000;
+    std::mt19937 gen(42);
 
-        // Handle the event based on its type
-        if (currentEvent.getEventType() == EventType::Tap) {
-            handleTapEvent(currentEvent);
-        } else if (currentEvent.getEventType() == EventType::Swipe) {
-            handleSwipeEvent(currentEvent);
+    auto start = Clock::now();
+    uint64_t written;
+    {
+        TraceRecorder recorder(path);
+        for (int i = 0; i < events; ++i) {
+            EventType type = static_cast<EventType>(gen() % kEventTypeCount);
+            int x = static_cast<int>(type == EventType::Voice ? gen() % kVoiceCommandCount : gen() % 800);
+            recorder.record(Event(type, x, static_cast<int>(gen() % 600), i * 10000LL));
         }
+        written = recorder.close();
     }
+    double recordNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / events;
 
+    EventDispatcher dispatcher;
+    uint64_t handled = 0;
+    for (int type = 0; type < 6; ++type) {
+        dispatcher.addHandler(static_cast<EventType>(type), [&handled](const Event&) { handled++; });
+    }
+    ReplayStats stats = replayTrace(path, dispatcher, 0);
+    std::remove(path.c_str());
+
+    std::cout << "Trace: recorded " << written << " events at " << recordNs << " ns per event (" << written * sizeof(Event) / 1024
+              << " KiB), replayed " << handled << " at " << static_cast<int>(stats.events / stats.seconds / 1000)
+              << "k events/s" << (stats.events == written && stats.corrupt == 0 ? "" : " (MISMATCH)") << "\n";
+}
+
+// Gesture recognition cost per raw touch sample
+void benchmarkGestureRecognizer() {
+    using Clock = std::chrono::steady_clock;
+    std::mt19937 gen(42);
+    std::vector<TouchSample> samples;
+    int64_t t = 0;
+    for (int i = 0; i < 4000; ++i) {
+        simulateGesture(static_cast<GestureKind>(i % 4), gen, t, samples);
+        t = samples.back().timestampNs + 50000000;
+    }
+
+    GestureRecognizer recognizer;
+    size_t gestures = 0;
+    auto start = Clock::now();
+    for (const TouchSample& sample : samples) {
+        recognizer.process(sample, [&](const Event&) { gestures++; });
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / samples.size();
+    std::cout << "Gesture recognizer: " << samples.size() << " touch samples, " << gestures << " gestures, " << ns
+              << " ns per sample\n";
+}
+
+void runBenchmark() {
+    benchmarkEventCreation();
+    benchmarkGestureRecognizer();
+    benchmarkDispatcher();
+    benchmarkTrace();
+    const int producers = 3;
+    const int eventsPerProducer = 1000000;
+    benchmarkPipeline(BackpressurePolicy::Block, "Block", producers, eventsPerProducer);
+    benchmarkPipeline(BackpressurePolicy::DropOldest, "DropOldest", producers, eventsPerProducer);
+    benchmarkPipeline(BackpressurePolicy::Coalesce, "Coalesce", producers, eventsPerProducer);
+    benchmarkRotaryCoalescing();
+}
+
+// Run the simulated input devices and dispatch their events as they arrive, optionally
+// recording every dispatched event
+void runLiveSession(EventDispatcher& dispatcher, TraceRecorder* recorder) {
+    // Event ring shared by all input sources and drained by the dispatcher in real time
+    EventRing<Event> eventQueue(256);
+    std::atomic<int> activeProducers(3);
+
+    // Touch screen: raw 240 Hz samples of 8 random gestures, recognized as they stream in
+    std::thread touchThread([&] {
+        std::mt19937 gen(std::random_device{}());
+        EventProducer<Event> producer(eventQueue, BackpressurePolicy::Block);
+        GestureRecognizer recognizer;
+        auto emit = [&](const Event& gesture) { producer.submit(gesture); };
+        std::vector<TouchSample> samples;
+        for (int i = 0; i < 8; ++i) {
+            samples.clear();
+            simulateGesture(static_cast<GestureKind>(gen() % 4), gen, getCurrentTime(), samples);
+            for (const TouchSample& sample : samples) {
+                // Deliver each sample when the touch controller would
+                std::this_thread::sleep_for(std::chrono::nanoseconds(sample.timestampNs - getCurrentTime()));
+                recognizer.process(sample, emit);
+                recognizer.tick(getCurrentTime(), emit);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Pause between gestures
+        }
+        activeProducers--;
+    });
+
+    // Rotary encoder: bursts of turns, merged when the dispatcher falls behind
+    std::thread rotaryThread([&] {
+        std::mt19937 gen(std::random_device{}());
+        EventProducer<Event> producer(eventQueue, BackpressurePolicy::Coalesce);
+        for (int i = 0; i < 5; ++i) {
+            int detents = static_cast<int>(gen() % 5) - 2;
+            producer.submit(Event(EventType::Rotate, detents, 0, getCurrentTime()), mergeRotations);
+            std::this_thread::sleep_for(std::chrono::milliseconds(170));
+        }
+        producer.flush();
+        activeProducers--;
+    });
+
+    // Voice recognizer: a couple of commands; stale commands are dropped first
+    std::thread voiceThread([&] {
+        std::mt19937 gen(std::random_device{}());
+        EventProducer<Event> producer(eventQueue, BackpressurePolicy::DropOldest);
+        for (int i = 0; i < 2; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(400));
+            producer.submit(Event(EventType::Voice, static_cast<int>(gen() % 4), 0, getCurrentTime()));
+        }
+        activeProducers--;
+    });
+
+    // Process the events as they arrive
+    Event currentEvent;
+    int idleRounds = 0;
+    while (true) {
+        if (!eventQueue.tryPop(currentEvent)) {
+            if (activeProducers.load() != 0) {
+                backoff(idleRounds);
+                continue;
+            }
+            // All producers are done: stop once the ring is drained
+            if (!eventQueue.tryPop(currentEvent)) {
+                break;
+            }
+        }
+        idleRounds = 0;
+
+        if (recorder) {
+            recorder->record(currentEvent);
+        }
+        dispatcher.dispatch(currentEvent);
+    }
+
+    touchThread.join();
+    rotaryThread.join();
+    voiceThread.join();
+}
+
+int main(int argc, char* argv[]) {
+    std::string recordPath;
+    std::string replayPath;
+    double speed = 1.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bench") {
+            runBenchmark();
+            return 0;
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--speed" && i + 1 < argc) {
+            speed = std::stod(argv[++i]);  // 0 = as fast as possible
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--record trace.evt | --replay trace.evt [--speed factor] | --bench]\n";
+            return 1;
+        }
+    }
+
+    try {
+        // Handlers: the whole screen reacts to every gesture, and the home button on top of it to taps
+        EventDispatcher dispatcher;
+        dispatcher.addHandler(EventType::Tap, handleTapEvent);
+        dispatcher.addHandler(EventType::Swipe, handleSwipeEvent);
+        dispatcher.addHandler(EventType::LongPress, handleLongPressEvent);
+        dispatcher.addHandler(EventType::Pinch, handlePinchEvent);
+        dispatcher.addHandler(EventType::Rotate, handleRotateEvent);
+        dispatcher.addHandler(EventType::Voice, handleVoiceEvent);
+        dispatcher.addHandler(EventType::Tap, ScreenRegion{0, 0, 200, 150}, [](const Event&) {
+            std::cout << "  -> Home button pressed" << std::endl;
+        });
+
+        // Replay a recorded session instead of the simulated devices
+        if (!replayPath.empty()) {
+            ReplayStats stats = replayTrace(replayPath, dispatcher, speed);
+            std::cout << "Replayed " << stats.events << " events in " << stats.seconds << " s, worst lag behind the recording "
+                      << stats.maxLagNs / 1000 << " us";
+            if (stats.corrupt > 0) {
+                std::cout << ", skipped " << stats.corrupt << " corrupt records";
+            }
+            std::cout << "\n";
+            return 0;
+        }
+
+        if (!recordPath.empty()) {
+            TraceRecorder recorder(recordPath);
+            runLiveSession(dispatcher, &recorder);
+            std::cout << "Recorded " << recorder.close() << " events to " << recordPath << "\n";
+        } else {
+            runLiveSession(dispatcher, nullptr);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
     return 0;
 }
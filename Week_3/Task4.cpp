@@ -1,80 +1,913 @@
 #include <iostream>
 #include <unordered_map>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 using namespace std;
 
-class Theme {
-    string backgroundColor;
-    string fontColor;
-    int fontSize;
-    string iconStyle;
+// Packed 0xRRGGBBAA color
+using Color = uint32_t;
 
-public:
-    // Default constructor
-    Theme() : backgroundColor("default"), fontColor("default"), fontSize(12), iconStyle("default") {}
+constexpr Color rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+    return (Color(r) << 24) | (Color(g) << 16) | (Color(b) << 8) | a;
+}
 
-    // Constructor to initialize theme settings
-    Theme(string bgc, string fc, int fs, string is)
-        : backgroundColor(bgc), fontColor(fc), fontSize(fs), iconStyle(is) {}
+enum class IconStyle : uint8_t {
+    Default,
+    Square,
+    Round,
+    Simple
+};
+
+// Named colors accepted in theme definitions
+struct NamedColor {
+    const char* name;
+    Color color;
+};
+
+const NamedColor namedColors[] = {
+    {"default", rgba(0, 0, 0)},
+    {"Blue", rgba(0, 0, 255)},
+    {"White", rgba(255, 255, 255)},
+    {"Red", rgba(255, 0, 0)},
+    {"Green", rgba(0, 128, 0)},
+    {"Dark Green", rgba(0, 100, 0)},
+};
+
+const char* const iconStyleNames[] = {"default", "Square", "Round", "Simple"};
+
+// Function to resolve a color name or "#RRGGBB" into a packed color (false if unknown)
+bool parseColor(const string& text, Color& color) {
+    for (const NamedColor& named : namedColors) {
+        if (text == named.name) {
+            color = named.color;
+            return true;
+        }
+    }
+    unsigned r, g, b;
+    if (text.size() == 7 && sscanf(text.c_str(), "#%02x%02x%02x", &r, &g, &b) == 3) {
+        color = rgba(r, g, b);
+        return true;
+    }
+    return false;
+}
+
+// Function to resolve an icon style name (false if unknown)
+bool parseIconStyle(const string& text, IconStyle& style) {
+    for (size_t i = 0; i < sizeof(iconStyleNames) / sizeof(iconStyleNames[0]); ++i) {
+        if (text == iconStyleNames[i]) {
+            style = static_cast<IconStyle>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to turn a packed color back into its name, or "#RRGGBB" if it has none
+string colorName(Color color) {
+    for (const NamedColor& named : namedColors) {
+        if (named.color == color) {
+            return named.name;
+        }
+    }
+    char text[8];
+    snprintf(text, sizeof(text), "#%02X%02X%02X", color >> 24, (color >> 16) & 0xFF, (color >> 8) & 0xFF);
+    return text;
+}
+
+// Theme settings, resolved into numbers when the theme is registered so widgets never touch strings
+struct Theme {
+    Color backgroundColor;
+    Color fontColor;
+    uint16_t fontSize;
+    IconStyle iconStyle;
 
     // Method to display the settings of the theme
-    void displaySettings(const string& themeName) const {
-        cout << themeName << " Theme: " 
-             << backgroundColor << " Background, " 
-             << fontColor << " Font, " 
-             << iconStyle << " Icon Style, " 
+    void displaySettings(const string& themeName, const char* kind = "Theme") const {
+        cout << themeName << " " << kind << ": "
+             << colorName(backgroundColor) << " Background, "
+             << colorName(fontColor) << " Font, "
+             << iconStyleNames[static_cast<int>(iconStyle)] << " Icon Style, "
              << fontSize << " Font Size" << endl;
     }
 };
 
-int main() {
-    // Create an unordered_map to store themes with their names
-    unordered_map<string, Theme> themeMap;
-
-    // Create theme objects with their respective settings
-    Theme classic("Blue", "White", 12, "Square");
-    Theme sport("Red", "White", 14, "Round");
-    Theme eco("Green", "Dark Green", 10, "Simple");
-
-    // Insert themes into the map
-    themeMap["Classic"] = classic;
-    themeMap["Sport"] = sport;
-    themeMap["Eco"] = eco;
-
-    // Menu loop for user interaction
-    while (true) {
-        cout << "\n1. Select a theme" << endl;
-        cout << "2. Exit" << endl;
-        cout << "Enter option: ";
-        int option;
-        cin >> option;
-
-        if (option == 1) {
-            // Display available themes to the user
-            cout << "Available Themes:" << endl;
-            cout << " Classic" << endl;
-            cout << " Sport" << endl;
-            cout << " Eco" << endl;
-            cout << "\nEnter the theme name : ";
-            
-            // Ask the user to select a theme
-            string selectedTheme;
-            cin >> selectedTheme;
-            
-            // Check if the theme exists in the map and display its settings
-            if (themeMap.find(selectedTheme) != themeMap.end()) {
-                cout << "\nApplying settings for the " << selectedTheme << " theme:" << endl;
-                // Directly call displaySettings for the selected theme
-                themeMap[selectedTheme].displaySettings(selectedTheme);
+static_assert(is_trivially_copyable<Theme>::value, "themes are plain data");
+
+using ThemeId = uint16_t;
+using WidgetId = uint16_t;
+const ThemeId kNoTheme = 0xFFFF;
+
+// Fields of a style that an override sets; the others are inherited
+enum StyleField : uint8_t {
+    kBackgroundField = 1,
+    kFontColorField = 2,
+    kFontSizeField = 4,
+    kIconStyleField = 8
+};
+
+// Partial style: a theme's own settings or a per-widget override
+struct StyleOverride {
+    uint8_t fields = 0;
+    Theme values{};
+
+    // Set the fields of other on top of this override
+    void merge(const StyleOverride& other) {
+        other.applyTo(values);
+        fields |= other.fields;
+    }
+
+    void applyTo(Theme& style) const {
+        if (fields & kBackgroundField) style.backgroundColor = values.backgroundColor;
+        if (fields & kFontColorField) style.fontColor = values.fontColor;
+        if (fields & kFontSizeField) style.fontSize = values.fontSize;
+        if (fields & kIconStyleField) style.iconStyle = values.iconStyle;
+    }
+};
+
+// Function to build an override from textual settings; an empty string or a font size of 0
+// leaves that field inherited
+StyleOverride parseStyle(const string& background, const string& font, int fontSize, const string& icons) {
+    StyleOverride style;
+    if (!background.empty()) {
+        if (!parseColor(background, style.values.backgroundColor)) {
+            throw invalid_argument("unknown color " + background);
+        }
+        style.fields |= kBackgroundField;
+    }
+    if (!font.empty()) {
+        if (!parseColor(font, style.values.fontColor)) {
+            throw invalid_argument("unknown color " + font);
+        }
+        style.fields |= kFontColorField;
+    }
+    if (fontSize != 0) {
+        if (fontSize < 0 || fontSize > 0xFFFF) {
+            throw invalid_argument("invalid font size " + to_string(fontSize));
+        }
+        style.values.fontSize = static_cast<uint16_t>(fontSize);
+        style.fields |= kFontSizeField;
+    }
+    if (!icons.empty()) {
+        if (!parseIconStyle(icons, style.values.iconStyle)) {
+            throw invalid_argument("unknown icon style " + icons);
+        }
+        style.fields |= kIconStyleField;
+    }
+    return style;
+}
+
+// Style of anything a theme does not set
+const Theme kDefaultStyle = {rgba(0, 0, 0), rgba(0, 0, 0), 12, IconStyle::Default};
+
+// Theme definitions as written: each theme names a parent, sets some fields and overrides some
+// fields for individual widgets. The effective style of widget w in theme t starts from the
+// theme settings along the chain from the root theme down to t; then the overrides for w along
+// the same chain apply, so a widget override also survives the settings of derived themes.
+class ThemeSet {
+public:
+    struct ThemeDefinition {
+        string name;
+        ThemeId parent;
+        StyleOverride style;
+        unordered_map<WidgetId, StyleOverride> widgetStyles;
+    };
+
+    vector<ThemeDefinition> themes;  // Parents come before their children
+    vector<string> widgets;
+
+    // Add a theme; parent must already exist (or be empty for a root theme)
+    ThemeId addTheme(const string& name, const string& parent, const StyleOverride& style) {
+        if (findTheme(name) != kNoTheme) {
+            throw invalid_argument("theme " + name + " is already defined");
+        }
+        ThemeId parentId = kNoTheme;
+        if (!parent.empty() && (parentId = findTheme(parent)) == kNoTheme) {
+            throw invalid_argument("theme " + name + ": unknown parent theme " + parent);
+        }
+        if (themes.size() >= kNoTheme) {
+            throw length_error("too many themes");
+        }
+        themes.push_back(ThemeDefinition{name, parentId, style, {}});
+        return static_cast<ThemeId>(themes.size() - 1);
+    }
+
+    WidgetId addWidget(const string& name) {
+        if (widgets.size() >= 0xFFFF) {
+            throw length_error("too many widgets");
+        }
+        widgets.push_back(name);
+        return static_cast<WidgetId>(widgets.size() - 1);
+    }
+
+    // Override some fields of one widget in one theme (and in the themes inheriting from it)
+    void overrideWidget(ThemeId theme, WidgetId widget, const StyleOverride& style) {
+        themes[theme].widgetStyles[widget].merge(style);
+    }
+
+    // Id of a widget name, or 0xFFFF
+    WidgetId findWidget(const string& name) const {
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            if (widgets[i] == name) {
+                return static_cast<WidgetId>(i);
+            }
+        }
+        return 0xFFFF;
+    }
+
+    ThemeId findTheme(const string& name) const {
+        for (size_t i = 0; i < themes.size(); ++i) {
+            if (themes[i].name == name) {
+                return static_cast<ThemeId>(i);
+            }
+        }
+        return kNoTheme;
+    }
+
+    // Resolve one style by walking the inheritance chain (what the compiled table avoids)
+    Theme resolve(ThemeId theme, WidgetId widget) const {
+        ThemeId chain[64];
+        int depth = 0;
+        for (ThemeId t = theme; t != kNoTheme && depth < 64; t = themes[t].parent) {
+            chain[depth++] = t;
+        }
+        Theme style = kDefaultStyle;
+        for (int level = depth - 1; level >= 0; --level) {
+            themes[chain[level]].style.applyTo(style);
+        }
+        for (int level = depth - 1; level >= 0; --level) {
+            const ThemeDefinition& definition = themes[chain[level]];
+            auto it = definition.widgetStyles.find(widget);
+            if (it != definition.widgetStyles.end()) {
+                it->second.applyTo(style);
+            }
+        }
+        return style;
+    }
+};
+
+// The cascade compiled ahead of time: every theme's own style and every widget's style in
+// every theme, flattened so a lookup is one indexed load, styles[theme * widgetCount + widget].
+class StyleTable {
+    size_t widgetCount = 0;
+    vector<Theme> themeStyles;
+    vector<Theme> styles;
+    vector<string> themeNames;
+    unordered_map<string, ThemeId> themeIds;
+    vector<string> widgetNames;
+
+public:
+    StyleTable() = default;
+
+    explicit StyleTable(const ThemeSet& set) : widgetCount(set.widgets.size()), widgetNames(set.widgets) {
+        size_t themeCount = set.themes.size();
+        themeStyles.resize(themeCount);
+        styles.resize(themeCount * widgetCount);
+        for (ThemeId t = 0; t < themeCount; ++t) {
+            const ThemeSet::ThemeDefinition& definition = set.themes[t];
+            themeNames.push_back(definition.name);
+            themeIds.emplace(definition.name, t);
+
+            // Parents are compiled first, so a theme's own style starts from its parent's
+            Theme base = definition.parent == kNoTheme ? kDefaultStyle : themeStyles[definition.parent];
+            definition.style.applyTo(base);
+            themeStyles[t] = base;
+
+            // Every widget starts from the theme's style; then the widget overrides of the whole
+            // chain apply, root first
+            Theme* row = &styles[t * widgetCount];
+            fill(row, row + widgetCount, base);
+            vector<ThemeId> chain;
+            for (ThemeId level = t; level != kNoTheme; level = set.themes[level].parent) {
+                chain.push_back(level);
+            }
+            for (auto level = chain.rbegin(); level != chain.rend(); ++level) {
+                for (const auto& widgetStyle : set.themes[*level].widgetStyles) {
+                    widgetStyle.second.applyTo(row[widgetStyle.first]);
+                }
+            }
+        }
+    }
+
+    size_t themes() const { return themeStyles.size(); }
+    size_t widgets() const { return widgetCount; }
+    const string& themeName(ThemeId id) const { return themeNames[id]; }
+    const string& widgetName(WidgetId id) const { return widgetNames[id]; }
+    size_t memoryUsage() const { return (themeStyles.size() + styles.size()) * sizeof(Theme); }
+
+    // Id of a theme name, or kNoTheme
+    ThemeId find(const string& name) const {
+        auto it = themeIds.find(name);
+        return it == themeIds.end() ? kNoTheme : it->second;
+    }
+
+    const Theme& theme(ThemeId id) const { return themeStyles[id]; }
+    const Theme& style(ThemeId theme, WidgetId widget) const { return styles[theme * widgetCount + widget]; }
+    const Theme* row(ThemeId theme) const { return &styles[theme * widgetCount]; }
+};
+
+// Compiled themes plus the active selection, readable by the UI thread without locks.
+// Names are only looked up when a theme is chosen; the active theme is published as a pointer
+// to its row of widget styles, so a widget reads its style with one atomic load and one
+// indexed load.
+//
+// New definitions (a hot reload) are compiled off the UI thread and published RCU-style by
+// swapping the table pointer. A replaced table is retired rather than freed: the UI thread
+// reports a quiescent state once per frame (when it holds no style references), and a retired
+// table is freed once the UI has passed a quiescent state after the swap.
+class ThemeRegistry {
+    atomic<const StyleTable*> table{nullptr};
+    atomic<const Theme*> activeRow{nullptr};
+    atomic<ThemeId> activeId{kNoTheme};
+
+    mutex writerMutex;  // Serializes publish and select
+    atomic<uint64_t> epoch{1};    // Advanced by every publish
+    atomic<uint64_t> uiEpoch{0};  // Epoch seen at the UI thread's last quiescent state
+    vector<pair<uint64_t, const StyleTable*>> retired;  // Tables to free, with their retire epoch
+
+    // Free the retired tables the UI can no longer be reading; writerMutex must be held
+    void reclaim() {
+        uint64_t seen = uiEpoch.load();
+        auto done = partition(retired.begin(), retired.end(),
+                              [seen](const pair<uint64_t, const StyleTable*>& r) { return r.first > seen; });
+        for (auto it = done; it != retired.end(); ++it) {
+            delete it->second;
+        }
+        retired.erase(done, retired.end());
+    }
+
+public:
+    // Compile the definitions; selects the first theme
+    explicit ThemeRegistry(const ThemeSet& set) {
+        publish(set);
+    }
+
+    ThemeRegistry(const ThemeRegistry&) = delete;
+    ThemeRegistry& operator=(const ThemeRegistry&) = delete;
+
+    ~ThemeRegistry() {
+        for (const auto& r : retired) {
+            delete r.second;
+        }
+        delete table.load();
+    }
+
+    // Compile new definitions and swap them in; the active theme is kept if it still exists.
+    // May be called from any thread.
+    void publish(const ThemeSet& set) {
+        unique_ptr<StyleTable> compiled(new StyleTable(set));
+        if (compiled->themes() == 0) {
+            throw invalid_argument("no themes defined");
+        }
+
+        lock_guard<mutex> lock(writerMutex);
+        const StyleTable* old = table.load();
+        ThemeId id = old ? compiled->find(old->themeName(activeId.load())) : kNoTheme;
+        if (id == kNoTheme) {
+            id = 0;
+        }
+        activeId.store(id);
+        activeRow.store(compiled->row(id));
+        table.store(compiled.release());
+        if (old) {
+            retired.emplace_back(epoch.fetch_add(1) + 1, old);
+        }
+        reclaim();
+    }
+
+    // The UI thread calls this between frames, when it holds no references into the styles
+    void quiescent() {
+        uiEpoch.store(epoch.load());
+    }
+
+    // Free what the UI has let go of (the reload thread calls this while idle)
+    void collect() {
+        lock_guard<mutex> lock(writerMutex);
+        reclaim();
+    }
+
+    size_t retiredTables() {
+        lock_guard<mutex> lock(writerMutex);
+        return retired.size();
+    }
+
+    // Current tables; valid on the UI thread until its next quiescent()
+    const StyleTable& styles() const { return *table.load(); }
+
+    // Switch the active theme
+    void select(ThemeId id) {
+        lock_guard<mutex> lock(writerMutex);
+        activeId.store(id);
+        activeRow.store(table.load()->row(id));
+    }
+
+    // Switch the active theme by name; false if there is no such theme
+    bool select(const string& name) {
+        lock_guard<mutex> lock(writerMutex);
+        ThemeId id = table.load()->find(name);
+        if (id == kNoTheme) {
+            return false;
+        }
+        activeId.store(id);
+        activeRow.store(table.load()->row(id));
+        return true;
+    }
+
+    ThemeId active() const { return activeId.load(); }
+
+    // Style of a widget in the active theme
+    const Theme& style(WidgetId widget) const { return activeRow.load(memory_order_acquire)[widget]; }
+};
+
+// Widgets of the dashboard, in WidgetId order
+const char* const kDashboardWidgets[] = {"Speedometer", "Tachometer", "FuelGauge", "Clock", "WarningLights"};
+
+// Function to start a theme set with the dashboard widgets
+ThemeSet dashboardThemeSet() {
+    ThemeSet set;
+    for (const char* widget : kDashboardWidgets) {
+        set.addWidget(widget);
+    }
+    return set;
+}
+
+// Function to parse a theme file:
+//
+//   [Sport]                     a root theme
+//   background = Red            background, font, fontSize, icons
+//   Tachometer.font = Red       override for one widget
+//   [Sport.Night : Sport]       a theme inheriting from Sport
+//
+// Colors are names or #RRGGBB; '#' at the start of a line begins a comment.
+ThemeSet parseThemeFile(istream& in) {
+    ThemeSet set = dashboardThemeSet();
+    ThemeId theme = kNoTheme;
+    string line;
+    int lineNumber = 0;
+    auto trim = [](const string& text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        size_t last = text.find_last_not_of(" \t\r");
+        return first == string::npos ? string() : text.substr(first, last - first + 1);
+    };
+
+    while (getline(in, line)) {
+        lineNumber++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        try {
+            if (line[0] == '[') {
+                if (line.back() != ']') {
+                    throw invalid_argument("missing ']'");
+                }
+                string header = line.substr(1, line.size() - 2);
+                size_t colon = header.find(':');
+                string name = trim(header.substr(0, colon));
+                string parent = colon == string::npos ? "" : trim(header.substr(colon + 1));
+                if (name.empty()) {
+                    throw invalid_argument("missing theme name");
+                }
+                theme = set.addTheme(name, parent, StyleOverride());
+                continue;
+            }
+
+            size_t equals = line.find('=');
+            if (equals == string::npos) {
+                throw invalid_argument("expected key = value");
+            }
+            if (theme == kNoTheme) {
+                throw invalid_argument("setting outside a [theme] section");
+            }
+            string key = trim(line.substr(0, equals));
+            string value = trim(line.substr(equals + 1));
+
+            // Widget.key sets an override for that widget
+            WidgetId widget = 0xFFFF;
+            size_t dot = key.find('.');
+            if (dot != string::npos) {
+                widget = set.findWidget(key.substr(0, dot));
+                if (widget == 0xFFFF) {
+                    throw invalid_argument("unknown widget " + key.substr(0, dot));
+                }
+                key = key.substr(dot + 1);
+            }
+
+            StyleOverride style;
+            if (key == "background") {
+                style = parseStyle(value, "", 0, "");
+            } else if (key == "font") {
+                style = parseStyle("", value, 0, "");
+            } else if (key == "fontSize") {
+                size_t used = 0;
+                int size = 0;
+                try {
+                    size = stoi(value, &used);
+                } catch (const logic_error&) {
+                    used = 0;
+                }
+                if (used == 0 || used != value.size() || size <= 0) {
+                    throw invalid_argument("invalid font size " + value);
+                }
+                style = parseStyle("", "", size, "");
+            } else if (key == "icons") {
+                style = parseStyle("", "", 0, value);
+            } else {
+                throw invalid_argument("unknown setting " + key);
+            }
+
+            if (widget == 0xFFFF) {
+                set.themes[theme].style.merge(style);
             } else {
-                cout << "Invalid theme selected!" << endl;
+                set.overrideWidget(theme, widget, style);
+            }
+        } catch (const logic_error& e) {
+            throw runtime_error("line " + to_string(lineNumber) + ": " + e.what());
+        }
+    }
+    return set;
+}
+
+// Function to load a theme file
+ThemeSet loadThemeFile(const string& path) {
+    ifstream in(path);
+    if (!in) {
+        throw runtime_error("cannot open theme file " + path);
+    }
+    return parseThemeFile(in);
+}
+
+// Watches a theme file with inotify and republishes the themes whenever it is saved. Parsing and
+// compiling run on the watcher thread; a file with errors is reported and the current themes
+// stay in place. The directory is watched rather than the file, so editors that save by writing
+// a new file and renaming it over the old one are noticed too.
+class ThemeWatcher {
+    ThemeRegistry& registry;
+    string path;
+    string fileName;
+    int inotifyFd = -1;
+    atomic<bool> running{true};
+    thread worker;
+
+    void reload() {
+        try {
+            ThemeSet set = loadThemeFile(path);
+            registry.publish(set);
+            cout << "\n[Themes reloaded from " << path << ": " << set.themes.size() << " themes]" << endl;
+        } catch (const exception& e) {
+            cerr << "\n[Theme file " << path << " not applied: " << e.what() << "]" << endl;
+        }
+    }
+
+    void watch() {
+        alignas(inotify_event) char buffer[4096];
+        while (running.load()) {
+            pollfd descriptor{inotifyFd, POLLIN, 0};
+            if (poll(&descriptor, 1, 100) <= 0) {
+                registry.collect();  // Idle: free the tables the UI is done with
+                continue;
+            }
+            ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            bool changed = false;
+            for (ssize_t offset = 0; offset < length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                if (event->len > 0 && fileName == event->name) {
+                    changed = true;
+                }
+                offset += sizeof(inotify_event) + event->len;
+            }
+            if (changed) {
+                reload();
+            }
+        }
+    }
+
+public:
+    ThemeWatcher(ThemeRegistry& themeRegistry, const string& themePath) : registry(themeRegistry), path(themePath) {
+        size_t slash = path.find_last_of('/');
+        string directory = slash == string::npos ? "." : path.substr(0, slash);
+        fileName = slash == string::npos ? path : path.substr(slash + 1);
+
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0 || inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            if (inotifyFd >= 0) {
+                close(inotifyFd);
+            }
+            throw runtime_error("cannot watch " + directory + " for theme changes");
+        }
+        worker = thread(&ThemeWatcher::watch, this);
+    }
+
+    ThemeWatcher(const ThemeWatcher&) = delete;
+    ThemeWatcher& operator=(const ThemeWatcher&) = delete;
+
+    ~ThemeWatcher() {
+        running = false;
+        worker.join();
+        close(inotifyFd);
+    }
+};
+
+// Function to define the production themes: day and night variants of Classic, Sport and Eco
+// for each market, with per-widget overrides
+ThemeSet productionThemes() {
+    ThemeSet set = dashboardThemeSet();
+    WidgetId speedometer = set.findWidget("Speedometer");
+    WidgetId tachometer = set.findWidget("Tachometer");
+    WidgetId fuelGauge = set.findWidget("FuelGauge");
+    WidgetId warningLights = set.findWidget("WarningLights");
+
+    struct Market {
+        const char* name;
+        int fontSize;  // Some scripts need larger text
+    };
+    const Market markets[] = {{"EU", 0}, {"US", 0}, {"CN", 16}};
+
+    ThemeId classic = set.addTheme("Classic", "", parseStyle("Blue", "White", 12, "Square"));
+    ThemeId sport = set.addTheme("Sport", "", parseStyle("Red", "White", 14, "Round"));
+    ThemeId eco = set.addTheme("Eco", "", parseStyle("Green", "Dark Green", 10, "Simple"));
+    set.overrideWidget(sport, tachometer, parseStyle("", "Red", 18, ""));
+    set.overrideWidget(eco, fuelGauge, parseStyle("", "", 14, "Round"));
+    for (ThemeId root : {classic, sport, eco}) {
+        set.overrideWidget(root, warningLights, parseStyle("", "Red", 0, ""));
+    }
+
+    for (ThemeId root : {classic, sport, eco}) {
+        string rootName = set.themes[root].name;
+        set.addTheme(rootName + ".Day", rootName, StyleOverride());
+        ThemeId night = set.addTheme(rootName + ".Night", rootName, parseStyle("#101820", "#C0C0C0", 0, ""));
+        set.overrideWidget(night, speedometer, parseStyle("", "White", 0, ""));
+        for (const char* variant : {".Day", ".Night"}) {
+            for (const Market& market : markets) {
+                ThemeId id = set.addTheme(rootName + variant + "." + market.name, rootName + variant,
+                                          parseStyle("", "", market.fontSize, ""));
+                if (string(market.name) == "US") {
+                    set.overrideWidget(id, speedometer, parseStyle("", "", 0, "Round"));  // mph dial
+                }
+            }
+        }
+    }
+    return set;
+}
+
+// The previous string-based theme, kept as the baseline for --bench
+class StringTheme {
+public:
+    string backgroundColor;
+    string fontColor;
+    int fontSize;
+    string iconStyle;
+
+    StringTheme() : backgroundColor("default"), fontColor("default"), fontSize(12), iconStyle("default") {}
+    StringTheme(string bgc, string fc, int fs, string is)
+        : backgroundColor(bgc), fontColor(fc), fontSize(fs), iconStyle(is) {}
+};
+
+// Cost of a theme switch as seen by 1000 widgets re-reading their style: string map lookups
+// and string copies against the compiled registry
+void benchmarkThemeSwitch() {
+    using Clock = chrono::steady_clock;
+    const int widgets = 1000;
+    const int switches = 2000;
+    const char* themeNames[] = {"Classic", "Sport", "Eco"};
+
+    unordered_map<string, StringTheme> themeMap;
+    themeMap["Classic"] = StringTheme("Blue", "White", 12, "Square");
+    themeMap["Sport"] = StringTheme("Red", "White", 14, "Round");
+    themeMap["Eco"] = StringTheme("Green", "Dark Green", 10, "Simple");
+
+    ThemeSet set;
+    set.addTheme("Classic", "", parseStyle("Blue", "White", 12, "Square"));
+    set.addTheme("Sport", "", parseStyle("Red", "White", 14, "Round"));
+    set.addTheme("Eco", "", parseStyle("Green", "Dark Green", 10, "Simple"));
+    for (int w = 0; w < widgets; ++w) {
+        set.addWidget("Widget" + to_string(w));
+    }
+    ThemeRegistry registry(set);
+
+    size_t checksum = 0;
+    auto start = Clock::now();
+    for (int s = 0; s < switches; ++s) {
+        string selected = themeNames[s % 3];
+        for (int w = 0; w < widgets; ++w) {
+            if (themeMap.find(selected) != themeMap.end()) {
+                StringTheme style = themeMap[selected];
+                checksum += style.backgroundColor.size() + style.fontColor.size() + style.iconStyle.size() + style.fontSize;
+            }
+        }
+    }
+    double stringUs = chrono::duration<double, micro>(Clock::now() - start).count() / switches;
+
+    ThemeId ids[] = {registry.styles().find("Classic"), registry.styles().find("Sport"), registry.styles().find("Eco")};
+    start = Clock::now();
+    for (int s = 0; s < switches; ++s) {
+        registry.select(ids[s % 3]);
+        for (WidgetId w = 0; w < widgets; ++w) {
+            const Theme& style = registry.style(w);
+            checksum += style.backgroundColor + style.fontColor + style.fontSize + static_cast<int>(style.iconStyle);
+        }
+    }
+    double packedUs = chrono::duration<double, micro>(Clock::now() - start).count() / switches;
+
+    cout << "Theme switch seen by " << widgets << " widgets: string map " << stringUs << " us, packed registry "
+         << packedUs << " us (Theme is " << sizeof(Theme) << " bytes)" << endl;
+    volatile size_t sink = checksum;
+    (void)sink;
+}
+
+// Style lookup cost for 1000 widgets x 50 themes: the compiled table against walking the
+// inheritance chain for every lookup
+void benchmarkCascade() {
+    using Clock = chrono::steady_clock;
+    const int widgets = 1000;
+    const int themes = 50;
+    const int lookups = 2000000;
+    mt19937 gen(42);
+
+    // Five root themes with inheritance chains of up to five levels; each theme overrides about
+    // 5% of the widgets
+    ThemeSet set;
+    for (int w = 0; w < widgets; ++w) {
+        set.addWidget("Widget" + to_string(w));
+    }
+    for (int t = 0; t < themes; ++t) {
+        int parent = t < 5 ? -1 : t < 20 ? t - 5 : 10 + static_cast<int>(gen() % 10);
+        ThemeId id = set.addTheme("Theme" + to_string(t), parent < 0 ? "" : "Theme" + to_string(parent),
+                                  parseStyle(t % 2 ? "Blue" : "", "", 10 + t % 5, ""));
+        for (int w = 0; w < widgets / 20; ++w) {
+            set.overrideWidget(id, static_cast<WidgetId>(gen() % widgets), parseStyle("", "Red", 0, t % 3 ? "Round" : ""));
+        }
+    }
+
+    auto start = Clock::now();
+    StyleTable table(set);
+    double compileMs = chrono::duration<double, milli>(Clock::now() - start).count();
+
+    vector<pair<ThemeId, WidgetId>> queries;
+    for (int i = 0; i < lookups; ++i) {
+        queries.push_back({static_cast<ThemeId>(gen() % themes), static_cast<WidgetId>(gen() % widgets)});
+    }
+
+    size_t checksumWalk = 0;
+    start = Clock::now();
+    for (const auto& query : queries) {
+        Theme style = set.resolve(query.first, query.second);
+        checksumWalk += style.backgroundColor + style.fontColor + style.fontSize + static_cast<int>(style.iconStyle);
+    }
+    double walkNs = chrono::duration<double, nano>(Clock::now() - start).count() / lookups;
+
+    size_t checksumTable = 0;
+    start = Clock::now();
+    for (const auto& query : queries) {
+        const Theme& style = table.style(query.first, query.second);
+        checksumTable += style.backgroundColor + style.fontColor + style.fontSize + static_cast<int>(style.iconStyle);
+    }
+    double tableNs = chrono::duration<double, nano>(Clock::now() - start).count() / lookups;
+
+    cout << "Style lookup, " << widgets << " widgets x " << themes << " themes: compiled table " << tableNs
+         << " ns, chain walk " << walkNs << " ns (compiled in " << compileMs << " ms, " << table.memoryUsage() / 1024
+         << " KiB" << (checksumWalk == checksumTable ? "" : ", MISMATCH") << ")" << endl;
+}
+
+// Style lookups on a UI thread while themes are republished from another thread: lookup cost
+// and how many replaced tables were waiting to be freed at most
+void benchmarkHotReload() {
+    using Clock = chrono::steady_clock;
+    const int reloads = 200;
+    const int framesWidgets = 1000;  // Lookups per UI frame
+
+    ThemeSet set = productionThemes();
+    ThemeRegistry registry(set);
+    atomic<bool> running(true);
+    size_t checksum = 0;
+    uint64_t lookups = 0;
+    size_t maxRetired = 0;
+
+    double lookupNs = 0;
+    thread ui([&] {
+        auto start = Clock::now();
+        while (running.load()) {
+            for (int i = 0; i < framesWidgets; ++i) {
+                const Theme& style = registry.style(static_cast<WidgetId>(i % set.widgets.size()));
+                checksum += style.backgroundColor + style.fontSize;
+            }
+            lookups += framesWidgets;
+            registry.quiescent();
+        }
+        lookupNs = chrono::duration<double, nano>(Clock::now() - start).count() / lookups;
+    });
+
+    auto start = Clock::now();
+    for (int i = 0; i < reloads; ++i) {
+        registry.publish(set);
+        maxRetired = max(maxRetired, registry.retiredTables());
+        this_thread::sleep_for(chrono::microseconds(500));
+    }
+    double publishUs = chrono::duration<double, micro>(Clock::now() - start).count() / reloads - 500;
+    running = false;
+    ui.join();
+
+    cout << "Hot reload: " << reloads << " republishes during " << lookups << " UI lookups, " << lookupNs
+         << " ns per lookup, compile and publish about " << max(publishUs, 0.0) << " us, at most " << maxRetired
+         << " tables awaiting reclamation" << endl;
+    volatile size_t sink = checksum;
+    (void)sink;
+}
+
+void runBenchmark() {
+    benchmarkThemeSwitch();
+    benchmarkCascade();
+    benchmarkHotReload();
+}
+
+int main(int argc, char* argv[]) {
+    string themePath;
+    if (argc == 2 && string(argv[1]) == "--bench") {
+        runBenchmark();
+        return 0;
+    } else if (argc == 3 && string(argv[1]) == "--themes") {
+        themePath = argv[2];  // Load the themes from a file and reload them whenever it is saved
+    } else if (argc != 1) {
+        cerr << "Usage: " << argv[0] << " [--themes themes.txt | --bench]" << endl;
+        return 1;
+    }
+
+    try {
+        // Compile the theme definitions; every style is resolved into packed values here, once
+        ThemeRegistry registry(themePath.empty() ? productionThemes() : loadThemeFile(themePath));
+        unique_ptr<ThemeWatcher> watcher;
+        if (!themePath.empty()) {
+            watcher.reset(new ThemeWatcher(registry, themePath));
+        }
+
+        // Menu loop for user interaction; every pass is one UI frame
+        while (true) {
+            registry.quiescent();  // No style references are held between frames
+            const StyleTable& styles = registry.styles();
+
+            cout << "\n1. Select a theme" << endl;
+            cout << "2. Exit" << endl;
+            cout << "3. Show the active theme" << endl;
+            cout << "Enter option: ";
+            int option;
+            if (!(cin >> option)) {
+                break;
+            }
+
+            if (option == 1) {
+                // Display available themes to the user
+                cout << "Available Themes:" << endl;
+                for (ThemeId id = 0; id < styles.themes(); ++id) {
+                    cout << " " << styles.themeName(id) << endl;
+                }
+                cout << "\nEnter the theme name : ";
+
+                // Ask the user to select a theme
+                string selectedTheme;
+                cin >> selectedTheme;
+
+                if (registry.select(selectedTheme)) {
+                    cout << "\nApplying settings for the " << selectedTheme << " theme:" << endl;
+                    option = 3;
+                } else {
+                    cout << "Invalid theme selected!" << endl;
+                }
+            } else if (option == 2) {
+                // Exit the loop and end the program
+                break;
+            } else if (option != 3) {
+                cout << "Invalid option. Please try again." << endl;
+            }
+
+            if (option == 3) {
+                // The themes may have been reloaded while waiting for input
+                const StyleTable& current = registry.styles();
+                ThemeId id = registry.active();
+                current.theme(id).displaySettings(current.themeName(id));
+                for (WidgetId widget = 0; widget < current.widgets(); ++widget) {
+                    registry.style(widget).displaySettings("  " + current.widgetName(widget), "style");
+                }
             }
-        } else if (option == 2) {
-            // Exit the loop and end the program
-            break;
-        } else {
-            cout << "Invalid option. Please try again." << endl;
         }
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
     }
 
-    return 0;  
-}
\ No newline at end of file
+    return 0;
+}
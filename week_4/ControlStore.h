@@ -0,0 +1,428 @@
+#ifndef CONTROL_STORE_H
+#define CONTROL_STORE_H
+
+// Compact control storage shared by the week 4 tasks: control types and states are one-byte
+// enums, and ControlStore keeps ids, types and states in separate packed arrays so filters
+// stream through one byte per control. The predicate kernels use AVX2 when the CPU has it
+// (detected at run time) and plain loops otherwise.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CONTROL_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+enum class ControlType : uint8_t {
+    Button,
+    Slider
+};
+
+enum class ControlState : uint8_t {
+    Visible,
+    Invisible,
+    Disabled,
+    Enabled
+};
+
+const size_t kControlTypeCount = 2;
+const size_t kControlStateCount = 4;
+
+inline const char* toString(ControlType type) {
+    static const char* const names[] = {"button", "slider"};
+    return names[static_cast<size_t>(type)];
+}
+
+inline const char* toString(ControlState state) {
+    static const char* const names[] = {"visible", "invisible", "disabled", "enabled"};
+    return names[static_cast<size_t>(state)];
+}
+
+inline ControlType parseControlType(const std::string& text) {
+    for (size_t i = 0; i < kControlTypeCount; ++i) {
+        if (text == toString(static_cast<ControlType>(i))) {
+            return static_cast<ControlType>(i);
+        }
+    }
+    throw std::invalid_argument("unknown control type " + text);
+}
+
+inline ControlState parseControlState(const std::string& text) {
+    for (size_t i = 0; i < kControlStateCount; ++i) {
+        if (text == toString(static_cast<ControlState>(i))) {
+            return static_cast<ControlState>(i);
+        }
+    }
+    throw std::invalid_argument("unknown control state " + text);
+}
+
+struct Control {
+    int id;             // Unique ID
+    ControlType type;
+    ControlState state;
+};
+
+// Byte-column kernels. n is the number of elements; results are element indexes.
+// On x86 each kernel has an AVX2 block loop compiled for that target alone and picked at run
+// time when the CPU supports it, so no -mavx2 flag is needed; the scalar loop handles the rest.
+namespace controlkernels {
+
+#ifdef CONTROL_KERNELS_X86
+#define CONTROL_KERNELS_AVX2 __attribute__((target("avx2")))
+
+// Whether the AVX2 block loops run on this CPU (checked once)
+inline bool usingAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// The AVX2 block loops: process whole 32-byte blocks from i and leave i at the first unprocessed byte
+
+CONTROL_KERNELS_AVX2 inline size_t countEqualAvx2(const uint8_t* data, size_t n, uint8_t value, size_t& i) {
+    size_t count = 0;
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        count += __builtin_popcount(mask);
+    }
+    return count;
+}
+
+CONTROL_KERNELS_AVX2 inline size_t countEqual2Avx2(const uint8_t* a, uint8_t va, const uint8_t* b, uint8_t vb,
+                                                   size_t n, size_t& i) {
+    size_t count = 0;
+    const __m256i needleA = _mm256_set1_epi8(static_cast<char>(va));
+    const __m256i needleB = _mm256_set1_epi8(static_cast<char>(vb));
+    for (; i + 32 <= n; i += 32) {
+        __m256i blockA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i blockB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i both = _mm256_and_si256(_mm256_cmpeq_epi8(blockA, needleA), _mm256_cmpeq_epi8(blockB, needleB));
+        count += __builtin_popcount(static_cast<uint32_t>(_mm256_movemask_epi8(both)));
+    }
+    return count;
+}
+
+// Returns true with i at the match if one was found
+CONTROL_KERNELS_AVX2 inline bool findFirstEqualAvx2(const uint8_t* data, size_t n, uint8_t value, size_t& i) {
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        if (mask != 0) {
+            i += __builtin_ctz(mask);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true with i at the match if one was found
+CONTROL_KERNELS_AVX2 inline bool findAdjacentEqualAvx2(const uint8_t* data, size_t n, size_t& i) {
+    for (; i + 33 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, next)));
+        if (mask != 0) {
+            i += __builtin_ctz(mask);
+            return true;
+        }
+    }
+    return false;
+}
+#else
+inline bool usingAvx2() { return false; }
+#endif
+
+// Number of bytes equal to value
+inline size_t countEqual(const uint8_t* data, size_t n, uint8_t value) {
+    size_t count = 0;
+    size_t i = 0;
+#ifdef CONTROL_KERNELS_X86
+    if (usingAvx2()) {
+        count = countEqualAvx2(data, n, value, i);
+    }
+#endif
+    for (; i < n; ++i) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+// Number of positions where a[i] == va and b[i] == vb
+inline size_t countEqual2(const uint8_t* a, uint8_t va, const uint8_t* b, uint8_t vb, size_t n) {
+    size_t count = 0;
+    size_t i = 0;
+#ifdef CONTROL_KERNELS_X86
+    if (usingAvx2()) {
+        count = countEqual2Avx2(a, va, b, vb, n, i);
+    }
+#endif
+    for (; i < n; ++i) {
+        count += (a[i] == va) & (b[i] == vb);
+    }
+    return count;
+}
+
+// Index of the first byte equal to value at or after from, or n
+inline size_t findFirstEqual(const uint8_t* data, size_t n, uint8_t value, size_t from = 0) {
+    size_t i = from;
+#ifdef CONTROL_KERNELS_X86
+    if (usingAvx2() && findFirstEqualAvx2(data, n, value, i)) {
+        return i;
+    }
+#endif
+    for (; i < n; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+// Index of the first byte equal to its successor, or n
+inline size_t findAdjacentEqual(const uint8_t* data, size_t n) {
+    if (n < 2) {
+        return n;
+    }
+    size_t i = 0;
+#ifdef CONTROL_KERNELS_X86
+    if (usingAvx2() && findAdjacentEqualAvx2(data, n, i)) {
+        return i;
+    }
+#endif
+    for (; i + 1 < n; ++i) {
+        if (data[i] == data[i + 1]) {
+            return i;
+        }
+    }
+    return n;
+}
+
+}  // namespace controlkernels
+
+// Which controls a state update applies to: a set of types and a set of states (all by default)
+struct ControlFilter {
+    uint8_t typeMask = 0xFF;
+    uint8_t stateMask = 0xFF;
+
+    ControlFilter& ofType(ControlType type) {
+        typeMask = uint8_t(1) << static_cast<int>(type);
+        return *this;
+    }
+
+    ControlFilter& inState(ControlState state) {
+        stateMask = uint8_t(1) << static_cast<int>(state);
+        return *this;
+    }
+
+    bool matches(ControlType type, ControlState state) const {
+        return ((typeMask >> static_cast<int>(type)) & 1) && ((stateMask >> static_cast<int>(state)) & 1);
+    }
+};
+
+// Set the state of every control matching a filter
+struct StateUpdate {
+    ControlFilter where;
+    ControlState state;
+};
+
+// Controls as parallel arrays: 6 bytes per control instead of a struct with two strings.
+// Copies share their columns until one of them writes (copy-on-write), so a snapshot of the
+// store is a few reference-count increments and a state change copies only the state column.
+class ControlStore {
+    template <typename T>
+    using Column = std::shared_ptr<std::vector<T>>;
+
+    Column<int32_t> idColumn = std::make_shared<std::vector<int32_t>>();
+    Column<uint8_t> typeColumn = std::make_shared<std::vector<uint8_t>>();
+    Column<uint8_t> stateColumn = std::make_shared<std::vector<uint8_t>>();
+
+    // Column for writing: copied first if another store still shares it
+    template <typename T>
+    static std::vector<T>& writable(Column<T>& column) {
+        if (column.use_count() > 1) {
+            column = std::make_shared<std::vector<T>>(*column);
+        }
+        return *column;
+    }
+
+public:
+    ControlStore() = default;
+
+    // Copying only shares the columns. There is no move: a moved-from store would be left
+    // without columns.
+    ControlStore(const ControlStore&) = default;
+    ControlStore& operator=(const ControlStore&) = default;
+
+    ControlStore(const std::vector<Control>& controls) {
+        reserve(controls.size());
+        for (const Control& control : controls) {
+            push_back(control);
+        }
+    }
+
+    void reserve(size_t n) {
+        writable(idColumn).reserve(n);
+        writable(typeColumn).reserve(n);
+        writable(stateColumn).reserve(n);
+    }
+
+    void push_back(const Control& control) {
+        writable(idColumn).push_back(control.id);
+        writable(typeColumn).push_back(static_cast<uint8_t>(control.type));
+        writable(stateColumn).push_back(static_cast<uint8_t>(control.state));
+    }
+
+    size_t size() const { return idColumn->size(); }
+    bool empty() const { return idColumn->empty(); }
+    size_t memoryUsage() const { return size() * (sizeof(int32_t) + 2); }
+
+    // True if this store and other share their state column (no state written since the copy)
+    bool sharesStatesWith(const ControlStore& other) const { return stateColumn == other.stateColumn; }
+
+    Control operator[](size_t i) const {
+        return Control{(*idColumn)[i], static_cast<ControlType>((*typeColumn)[i]), static_cast<ControlState>((*stateColumn)[i])};
+    }
+
+    int id(size_t i) const { return (*idColumn)[i]; }
+    ControlType type(size_t i) const { return static_cast<ControlType>((*typeColumn)[i]); }
+    ControlState state(size_t i) const { return static_cast<ControlState>((*stateColumn)[i]); }
+    void setState(size_t i, ControlState state) { writable(stateColumn)[i] = static_cast<uint8_t>(state); }
+
+    // Raw columns for kernels and bulk updates
+    const int32_t* ids() const { return idColumn->data(); }
+    const uint8_t* types() const { return typeColumn->data(); }
+    const uint8_t* states() const { return stateColumn->data(); }
+    uint8_t* states() { return writable(stateColumn).data(); }
+
+    size_t countState(ControlState state) const {
+        return controlkernels::countEqual(states(), size(), static_cast<uint8_t>(state));
+    }
+
+    size_t countTypeInState(ControlType type, ControlState state) const {
+        return controlkernels::countEqual2(types(), static_cast<uint8_t>(type), states(), static_cast<uint8_t>(state), size());
+    }
+
+    // Index of the first control in a state at or after from, or size()
+    size_t findFirstState(ControlState state, size_t from = 0) const {
+        return controlkernels::findFirstEqual(states(), size(), static_cast<uint8_t>(state), from);
+    }
+
+    // Index of the first control whose successor has the same state, or size()
+    size_t findAdjacentSameState() const {
+        return controlkernels::findAdjacentEqual(states(), size());
+    }
+
+    // Apply a list of state updates in order, as if each ran over all controls in turn, in a
+    // single pass. Since an update only looks at type and state, the whole list folds into a
+    // table from (type, state) to the final state. Returns the number of controls changed; the
+    // state column is not touched (or unshared) when nothing changes.
+    size_t applyUpdates(const std::vector<StateUpdate>& updates) {
+        uint8_t next[kControlTypeCount][kControlStateCount];
+        bool changes = false;
+        for (size_t type = 0; type < kControlTypeCount; ++type) {
+            for (size_t state = 0; state < kControlStateCount; ++state) {
+                ControlState result = static_cast<ControlState>(state);
+                for (const StateUpdate& update : updates) {
+                    if (update.where.matches(static_cast<ControlType>(type), result)) {
+                        result = update.state;
+                    }
+                }
+                next[type][state] = static_cast<uint8_t>(result);
+                changes |= next[type][state] != state;
+            }
+        }
+        if (!changes || empty()) {
+            return 0;
+        }
+
+        const uint8_t* typeData = types();
+        const uint8_t* before = stateColumn->data();  // Not states(): the non-const overload unshares
+        if (stateColumn.use_count() > 1) {
+            // Shared with a snapshot: write the new states into a fresh column
+            // instead of copying the old one first
+            auto updated = std::make_shared<std::vector<uint8_t>>(size());
+            size_t changed = 0;
+            for (size_t i = 0; i < size(); ++i) {
+                uint8_t state = next[typeData[i]][before[i]];
+                changed += state != before[i];
+                (*updated)[i] = state;
+            }
+            stateColumn = updated;
+            return changed;
+        }
+        uint8_t* stateData = stateColumn->data();
+        size_t changed = 0;
+        for (size_t i = 0; i < size(); ++i) {
+            uint8_t state = next[typeData[i]][stateData[i]];
+            changed += state != stateData[i];
+            stateData[i] = state;
+        }
+        return changed;
+    }
+
+    // Move the controls in a state to the front, keeping the relative order on both sides
+    // (a stable partition); returns how many there are
+    size_t partitionState(ControlState state) {
+        const uint8_t value = static_cast<uint8_t>(state);
+        const size_t matching = countState(state);
+        const std::vector<int32_t>& oldIds = *idColumn;
+        const std::vector<uint8_t>& oldTypes = *typeColumn;
+        const std::vector<uint8_t>& oldStates = *stateColumn;
+        auto ids = std::make_shared<std::vector<int32_t>>(size());
+        auto types = std::make_shared<std::vector<uint8_t>>(size());
+        auto newStates = std::make_shared<std::vector<uint8_t>>(size());
+        size_t front = 0;
+        size_t back = matching;
+        for (size_t i = 0; i < size(); ++i) {
+            bool match = oldStates[i] == value;
+            size_t dest = match ? front : back;  // Compiles to a select, not a branch
+            (*ids)[dest] = oldIds[i];
+            (*types)[dest] = oldTypes[i];
+            (*newStates)[dest] = oldStates[i];
+            front += match;
+            back += !match;
+        }
+        idColumn = ids;
+        typeColumn = types;
+        stateColumn = newStates;
+        return matching;
+    }
+
+    // Drop the controls in a state, keeping the order of the rest
+    void removeState(ControlState state) {
+        std::vector<int32_t>& ids = writable(idColumn);
+        std::vector<uint8_t>& types = writable(typeColumn);
+        std::vector<uint8_t>& states = writable(stateColumn);
+        size_t kept = 0;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (states[i] != static_cast<uint8_t>(state)) {
+                ids[kept] = ids[i];
+                types[kept] = types[i];
+                states[kept] = states[i];
+                kept++;
+            }
+        }
+        ids.resize(kept);
+        types.resize(kept);
+        states.resize(kept);
+    }
+
+    void reverse() {
+        std::vector<int32_t>& ids = writable(idColumn);
+        std::vector<uint8_t>& types = writable(typeColumn);
+        std::vector<uint8_t>& states = writable(stateColumn);
+        std::reverse(ids.begin(), ids.end());
+        std::reverse(types.begin(), types.end());
+        std::reverse(states.begin(), states.end());
+    }
+};
+
+#endif  // CONTROL_STORE_H
@@ -2,84 +2,241 @@
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include "ControlStore.h"
 
-struct Control {
-    int id;               // Unique ID
-    std::string type;     // "button" or "slider"
-    std::string state;    // "visible", "invisible", or "disabled"
+// Growable bitset over control slots
+class SlotBitset {
+    std::vector<uint64_t> words;
 
-    // Overload the equality operator to compare based on the `id`
-    bool operator==(const Control& other) const {
-        return this->id == other.id;  // Compare only the `id`
+public:
+    void resize(size_t bits) { words.resize((bits + 63) / 64, 0); }
+    void set(size_t bit) { words[bit / 64] |= uint64_t(1) << (bit % 64); }
+    void reset(size_t bit) { words[bit / 64] &= ~(uint64_t(1) << (bit % 64)); }
+    bool test(size_t bit) const { return (words[bit / 64] >> (bit % 64)) & 1; }
+    size_t wordCount() const { return words.size(); }
+    uint64_t word(size_t i) const { return words[i]; }
+
+    // First set bit at or after `from`, or npos
+    size_t findNext(size_t from) const {
+        size_t i = from / 64;
+        if (i >= words.size()) {
+            return npos;
+        }
+        uint64_t bits = words[i] & (~uint64_t(0) << (from % 64));
+        while (true) {
+            if (bits != 0) {
+                return i * 64 + __builtin_ctzll(bits);
+            }
+            if (++i == words.size()) {
+                return npos;
+            }
+            bits = words[i];
+        }
+    }
+
+    static const size_t npos = ~size_t(0);
+};
+
+// Controls in list order, with indexes kept up to date as controls are added or change state:
+// an id -> slot table, one bitset of slots per state and per type, and counters per state, per
+// type and per (type, state). Lookups by id and all counts are O(1); "first control in a state"
+// (or of a type in a state) scans the bitsets 64 slots per step. The id table is dense while ids stay within a few times the control count;
+// ids far beyond that go to a hash map, so a few huge ids cannot blow up memory.
+class ControlRegistry {
+    ControlStore controls;             // Slots in list order
+    std::vector<int32_t> slotOfId;     // Dense id -> slot, -1 if unused
+    std::unordered_map<int32_t, int32_t> sparseSlotOfId;  // Ids too large for the dense table
+    SlotBitset stateSlots[kControlStateCount];
+    SlotBitset typeSlots[kControlTypeCount];
+    size_t stateCounts[kControlStateCount] = {};
+    size_t typeCounts[kControlTypeCount] = {};
+    size_t typeStateCounts[kControlTypeCount][kControlStateCount] = {};
+
+public:
+    static const size_t npos = SlotBitset::npos;
+
+    ControlRegistry() = default;
+
+    ControlRegistry(const std::vector<Control>& initial) {
+        for (const Control& control : initial) {
+            add(control);
+        }
+    }
+
+    // Append a control; ids must be unique and non-negative
+    void add(const Control& control) {
+        if (control.id < 0) {
+            throw std::invalid_argument("control ids must be non-negative");
+        }
+        if (find(control.id) != npos) {
+            throw std::invalid_argument("duplicate control id " + std::to_string(control.id));
+        }
+
+        size_t slot = controls.size();
+        size_t id = static_cast<size_t>(control.id);
+        if (id >= slotOfId.size() && id < 4 * (slot + 256)) {
+            slotOfId.resize(std::min(std::max(id + 1, slotOfId.size() * 2), 4 * (slot + 256)), -1);
+        }
+        if (id < slotOfId.size()) {
+            slotOfId[id] = static_cast<int32_t>(slot);
+        } else {
+            sparseSlotOfId[control.id] = static_cast<int32_t>(slot);
+        }
+        controls.push_back(control);
+        if (slot % 64 == 0) {
+            for (SlotBitset& bits : stateSlots) bits.resize(slot + 64);
+            for (SlotBitset& bits : typeSlots) bits.resize(slot + 64);
+        }
+        size_t state = static_cast<size_t>(control.state);
+        size_t type = static_cast<size_t>(control.type);
+        stateSlots[state].set(slot);
+        typeSlots[type].set(slot);
+        stateCounts[state]++;
+        typeCounts[type]++;
+        typeStateCounts[type][state]++;
+    }
+
+    size_t size() const { return controls.size(); }
+    Control at(size_t slot) const { return controls[slot]; }
+    const ControlStore& store() const { return controls; }
+
+    // Slot of the control with the given id, or npos
+    size_t find(int id) const {
+        if (id < 0) {
+            return npos;
+        }
+        if (static_cast<size_t>(id) < slotOfId.size() && slotOfId[id] >= 0) {
+            return slotOfId[id];
+        }
+        // An id may have gone to the hash map before the dense table grew over it
+        auto it = sparseSlotOfId.find(id);
+        return it == sparseSlotOfId.end() ? npos : static_cast<size_t>(it->second);
+    }
+
+    // Change the state of a control, updating the indexes in place; false if the id is unknown
+    bool setState(int id, ControlState newState) {
+        size_t slot = find(id);
+        if (slot == npos) {
+            return false;
+        }
+        size_t oldState = static_cast<size_t>(controls.state(slot));
+        size_t state = static_cast<size_t>(newState);
+        size_t type = static_cast<size_t>(controls.type(slot));
+        stateSlots[oldState].reset(slot);
+        stateSlots[state].set(slot);
+        stateCounts[oldState]--;
+        stateCounts[state]++;
+        typeStateCounts[type][oldState]--;
+        typeStateCounts[type][state]++;
+        controls.setState(slot, newState);
+        return true;
+    }
+
+    size_t countState(ControlState state) const { return stateCounts[static_cast<size_t>(state)]; }
+    size_t countType(ControlType type) const { return typeCounts[static_cast<size_t>(type)]; }
+
+    size_t countTypeInState(ControlType type, ControlState state) const {
+        return typeStateCounts[static_cast<size_t>(type)][static_cast<size_t>(state)];
+    }
+
+    // Slot of the first control in a state, or npos
+    size_t findFirstInState(ControlState state) const {
+        return stateSlots[static_cast<size_t>(state)].findNext(0);
+    }
+
+    // Slot of the first control of a type in a state, or npos (ANDs the two bitsets word by word)
+    size_t findFirstOfTypeInState(ControlType type, ControlState state) const {
+        const SlotBitset& ofType = typeSlots[static_cast<size_t>(type)];
+        const SlotBitset& inState = stateSlots[static_cast<size_t>(state)];
+        for (size_t i = 0; i < ofType.wordCount(); ++i) {
+            uint64_t bits = ofType.word(i) & inState.word(i);
+            if (bits != 0) {
+                return i * 64 + __builtin_ctzll(bits);
+            }
+        }
+        return npos;
+    }
+
+    // Slot of the first control whose successor has the same state, or npos
+    size_t findConsecutiveSameState() const {
+        size_t slot = controls.findAdjacentSameState();
+        return slot == controls.size() ? npos : slot;
     }
 };
 
-// Function to iterate through all controls and print their details using std::for_each
-void printControls(const std::vector<Control>& controls) {
+// Function to print a control
+void printControl(const Control& ctrl) {
+    std::cout << "ID: " << ctrl.id << ", Type: " << toString(ctrl.type) << ", State: " << toString(ctrl.state) << std::endl;
+}
+
+// Function to iterate through all controls and print their details
+void printControls(const ControlRegistry& registry) {
     std::cout << "All controls:" << std::endl;
-    std::for_each(controls.begin(), controls.end(), [](const Control& ctrl) {
-        std::cout << "ID: " << ctrl.id << ", Type: " << ctrl.type << ", State: " << ctrl.state << std::endl;
-    });
+    for (size_t slot = 0; slot < registry.size(); ++slot) {
+        printControl(registry.at(slot));
+    }
 }
 
-// Function to find a control by ID using std::find
-void findControlById(const std::vector<Control>& controls, int searchId) {
-    Control searchControl = {searchId, "", ""};  // We only care about the ID, other fields are irrelevant
-    auto controlWithId = std::find(controls.begin(), controls.end(), searchControl);
+// Function to find a control by ID through the id index
+void findControlById(const ControlRegistry& registry, int searchId) {
+    size_t slot = registry.find(searchId);
 
-    if (controlWithId != controls.end()) {
-        std::cout << "Found control with ID " << searchId << ": Type = " << controlWithId->type 
-                  << ", State = " << controlWithId->state << std::endl;
+    if (slot != ControlRegistry::npos) {
+        Control controlWithId = registry.at(slot);
+        std::cout << "Found control with ID " << searchId << ": Type = " << toString(controlWithId.type)
+                  << ", State = " << toString(controlWithId.state) << std::endl;
     } else {
         std::cout << "Control with ID " << searchId << " not found!" << std::endl;
     }
 }
 
-// Function to find the first invisible control using std::find_if
-void findFirstInvisibleControl(const std::vector<Control>& controls) {
-    auto invisibleControl = std::find_if(controls.begin(), controls.end(), [](const Control& ctrl) {
-        return ctrl.state == "invisible";
-    });
-    if (invisibleControl != controls.end()) {
-        std::cout << "First invisible control: ID = " << invisibleControl->id << ", Type = " 
-                  << invisibleControl->type << std::endl;
+// Function to find the first invisible control through the state bitset
+void findFirstInvisibleControl(const ControlRegistry& registry) {
+    size_t slot = registry.findFirstInState(ControlState::Invisible);
+    if (slot != ControlRegistry::npos) {
+        Control invisibleControl = registry.at(slot);
+        std::cout << "First invisible control: ID = " << invisibleControl.id << ", Type = "
+                  << toString(invisibleControl.type) << std::endl;
     } else {
         std::cout << "No invisible controls found!" << std::endl;
     }
 }
 
-// Function to find consecutive controls with the same state using std::adjacent_find
-void findConsecutiveSameStateControls(const std::vector<Control>& controls) {
-    auto consecutiveSameState = std::adjacent_find(controls.begin(), controls.end(), [](const Control& a, const Control& b) {
-        return a.state == b.state;
-    });
-    if (consecutiveSameState != controls.end()) {
-        std::cout << "Found consecutive controls with the same state: ID1 = " << consecutiveSameState->id 
-                  << ", ID2 = " << (consecutiveSameState + 1)->id << std::endl;
+// Function to find consecutive controls with the same state with the adjacent-find kernel
+void findConsecutiveSameStateControls(const ControlRegistry& registry) {
+    size_t slot = registry.findConsecutiveSameState();
+    if (slot != ControlRegistry::npos) {
+        std::cout << "Found consecutive controls with the same state: ID1 = " << registry.at(slot).id
+                  << ", ID2 = " << registry.at(slot + 1).id << std::endl;
     } else {
         std::cout << "No consecutive controls with the same state!" << std::endl;
     }
 }
 
-// Function to count the number of visible controls using std::count_if
-void countVisibleControls(const std::vector<Control>& controls) {
-    int visibleCount = std::count_if(controls.begin(), controls.end(), [](const Control& ctrl) {
-        return ctrl.state == "visible";
-    });
-    std::cout << "Number of visible controls: " << visibleCount << std::endl;
+// Function to count the number of visible controls from the state counters
+void countVisibleControls(const ControlRegistry& registry) {
+    std::cout << "Number of visible controls: " << registry.countState(ControlState::Visible) << std::endl;
 }
 
-// Function to count the number of disabled sliders using std::count_if
-void countDisabledSliders(const std::vector<Control>& controls) {
-    int disabledSlidersCount = std::count_if(controls.begin(), controls.end(), [](const Control& ctrl) {
-        return ctrl.type == "slider" && ctrl.state == "disabled";
-    });
-    std::cout << "Number of disabled sliders: " << disabledSlidersCount << std::endl;
+// Function to count the number of disabled sliders from the (type, state) counters
+void countDisabledSliders(const ControlRegistry& registry) {
+    std::cout << "Number of disabled sliders: " << registry.countTypeInState(ControlType::Slider, ControlState::Disabled)
+              << std::endl;
 }
 
-// Function to compare the first 5 controls with the next 5 controls using std::equal
-void compareFirstFiveControls(const std::vector<Control>& controls) {
-    bool areIdentical = std::equal(controls.begin(), controls.begin() + 5, controls.begin() + 5);
+// Function to compare the ids of the first 5 controls with the next 5 controls using std::equal
+void compareFirstFiveControls(const ControlRegistry& registry) {
+    if (registry.size() < 10) {
+        std::cout << "Fewer than 10 controls to compare." << std::endl;
+        return;
+    }
+    const int32_t* ids = registry.store().ids();
+    bool areIdentical = std::equal(ids, ids + 5, ids + 5);
     if (areIdentical) {
         std::cout << "The first 5 controls are identical to the next 5 controls." << std::endl;
     } else {
@@ -87,19 +244,162 @@ void compareFirstFiveControls(const std::vector<Control>& controls) {
     }
 }
 
-int main() {
-    std::vector<Control> controls = {
-        {1, "button", "visible"},
-        {2, "button", "invisible"},
-        {3, "slider", "visible"},
-        {4, "slider", "disabled"},
-        {5, "button", "disabled"},
-        {6, "button", "visible"},
-        {7, "slider", "invisible"},
-        {8, "slider", "disabled"},
-        {9, "button", "invisible"},
-        {10, "slider", "visible"}
-    };
+// Function to change the state of a control; the registry indexes follow in place
+void changeControlState(ControlRegistry& registry, int id, ControlState state) {
+    if (registry.setState(id, state)) {
+        std::cout << "Control " << id << " is now " << toString(state) << std::endl;
+    } else {
+        std::cout << "Control with ID " << id << " not found!" << std::endl;
+    }
+}
+
+// The previous control representation, kept as the baseline for --bench
+struct StringControl {
+    int id;
+    std::string type;
+    std::string state;
+};
+
+// Per-frame queries over a screen of 100k controls: the registry against scanning the vector
+void benchmarkRegistry() {
+    using Clock = std::chrono::steady_clock;
+    const int count = 100000;
+    const int frames = 200;
+    const char* types[] = {"button", "slider"};
+    const char* states[] = {"visible", "invisible", "disabled"};
+    std::mt19937 gen(42);
+
+    std::vector<StringControl> controls;
+    for (int i = 0; i < count; ++i) {
+        controls.push_back({i + 1, types[gen() % 2], states[gen() % 3]});
+    }
+    // The first invisible control lies deep in the list
+    for (int i = 0; i < count * 9 / 10; ++i) {
+        if (controls[i].state == "invisible") {
+            controls[i].state = "visible";
+        }
+    }
+    ControlRegistry registry;
+    for (const StringControl& c : controls) {
+        registry.add({c.id, parseControlType(c.type), parseControlState(c.state)});
+    }
+    std::vector<int> ids;
+    for (int frame = 0; frame < frames; ++frame) {
+        ids.push_back(static_cast<int>(gen() % count) + 1);
+    }
+
+    // Each frame looks up a control, finds the first invisible control and the first disabled
+    // slider, counts, and changes a state
+    size_t checksum = 0;
+    auto start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        int id = ids[frame];
+        checksum += std::find_if(controls.begin(), controls.end(), [id](const StringControl& c) { return c.id == id; })->id;
+        checksum += std::find_if(controls.begin(), controls.end(), [](const StringControl& c) { return c.state == "invisible"; })->id;
+        checksum += std::find_if(controls.begin(), controls.end(), [](const StringControl& c) {
+            return c.type == "slider" && c.state == "disabled";
+        })->id;
+        checksum += std::count_if(controls.begin(), controls.end(), [](const StringControl& c) { return c.state == "visible"; });
+        checksum += std::count_if(controls.begin(), controls.end(), [](const StringControl& c) {
+            return c.type == "slider" && c.state == "disabled";
+        });
+        controls[id - 1].state = frame % 2 == 0 ? "disabled" : "visible";
+    }
+    double scanUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / frames;
+
+    size_t registryChecksum = 0;
+    start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        int id = ids[frame];
+        registryChecksum += registry.at(registry.find(id)).id;
+        registryChecksum += registry.at(registry.findFirstInState(ControlState::Invisible)).id;
+        registryChecksum += registry.at(registry.findFirstOfTypeInState(ControlType::Slider, ControlState::Disabled)).id;
+        registryChecksum += registry.countState(ControlState::Visible);
+        registryChecksum += registry.countTypeInState(ControlType::Slider, ControlState::Disabled);
+        registry.setState(id, frame % 2 == 0 ? ControlState::Disabled : ControlState::Visible);
+    }
+    double registryUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / frames;
+
+    std::cout << "Per-frame queries over " << count << " controls: vector scans " << scanUs << " us, registry "
+              << registryUs << " us" << (checksum == registryChecksum ? "" : " (MISMATCH)") << std::endl;
+}
+
+// Filters over a million controls: string structs against the packed columns and their kernels
+void benchmarkStore() {
+    using Clock = std::chrono::steady_clock;
+    using Micro = std::chrono::duration<double, std::micro>;
+    const size_t count = 1000000;
+    const char* typeNames[] = {"button", "slider"};
+    const char* stateNames[] = {"visible", "invisible", "disabled"};
+    std::mt19937 gen(42);
+
+    // States cycle so that no two neighbours match until near the end; no invisible control
+    // before the last 1% either
+    std::vector<StringControl> strings;
+    ControlStore store;
+    store.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t state = i < count - count / 100 ? (i % 2 == 0 ? 0 : 2) : gen() % 3;
+        size_t type = gen() % 2;
+        strings.push_back({static_cast<int>(i), typeNames[type], stateNames[state]});
+        store.push_back({static_cast<int>(i), static_cast<ControlType>(type), static_cast<ControlState>(state)});
+    }
+
+    auto start = Clock::now();
+    size_t a1 = std::count_if(strings.begin(), strings.end(), [](const StringControl& c) { return c.state == "visible"; });
+    size_t a2 = std::count_if(strings.begin(), strings.end(), [](const StringControl& c) {
+        return c.type == "slider" && c.state == "disabled";
+    });
+    size_t a3 = std::find_if(strings.begin(), strings.end(), [](const StringControl& c) { return c.state == "invisible"; }) - strings.begin();
+    size_t a4 = std::adjacent_find(strings.begin(), strings.end(), [](const StringControl& a, const StringControl& b) {
+        return a.state == b.state;
+    }) - strings.begin();
+    double stringFilterUs = Micro(Clock::now() - start).count();
+    start = Clock::now();
+    std::stable_partition(strings.begin(), strings.end(), [](const StringControl& c) { return c.state == "visible"; });
+    double stringPartitionUs = Micro(Clock::now() - start).count();
+
+    start = Clock::now();
+    size_t b1 = store.countState(ControlState::Visible);
+    size_t b2 = store.countTypeInState(ControlType::Slider, ControlState::Disabled);
+    size_t b3 = store.findFirstState(ControlState::Invisible);
+    size_t b4 = store.findAdjacentSameState();
+    double storeFilterUs = Micro(Clock::now() - start).count();
+    start = Clock::now();
+    store.partitionState(ControlState::Visible);
+    double storePartitionUs = Micro(Clock::now() - start).count();
+
+    bool same = a1 == b1 && a2 == b2 && a3 == b3 && a4 == b4;
+    std::cout << "Filters over " << count << " controls" << (controlkernels::usingAvx2() ? " (AVX2)" : " (scalar)")
+              << ": count/count/find/adjacent-find " << stringFilterUs << " us on strings, " << storeFilterUs
+              << " us on columns; stable partition " << stringPartitionUs << " us vs " << storePartitionUs << " us\n"
+              << "Memory per control: " << sizeof(StringControl) << " bytes as strings, " << sizeof(Control)
+              << " as a struct, " << store.memoryUsage() / count << " in columns" << (same ? "" : " (MISMATCH)") << std::endl;
+}
+
+void runBenchmark() {
+    benchmarkRegistry();
+    benchmarkStore();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        runBenchmark();
+        return 0;
+    }
+
+    ControlRegistry controls({
+        {1, ControlType::Button, ControlState::Visible},
+        {2, ControlType::Button, ControlState::Invisible},
+        {3, ControlType::Slider, ControlState::Visible},
+        {4, ControlType::Slider, ControlState::Disabled},
+        {5, ControlType::Button, ControlState::Disabled},
+        {6, ControlType::Button, ControlState::Visible},
+        {7, ControlType::Slider, ControlState::Invisible},
+        {8, ControlType::Slider, ControlState::Disabled},
+        {9, ControlType::Button, ControlState::Invisible},
+        {10, ControlType::Slider, ControlState::Visible}
+    });
 
     int choice;
     do {
@@ -111,8 +411,11 @@ int main() {
         std::cout << "5. Count visible controls\n";
         std::cout << "6. Count disabled sliders\n";
         std::cout << "7. Compare the first 5 controls with the next 5 controls\n";
+        std::cout << "8. Change the state of a control\n";
         std::cout << "Enter your choice: ";
-        std::cin >> choice;
+        if (!(std::cin >> choice)) {
+            break;
+        }
 
         switch (choice) {
             case 1:
@@ -147,6 +450,19 @@ int main() {
                 compareFirstFiveControls(controls);
                 break;
 
+            case 8: {
+                int id;
+                std::string state;
+                std::cout << "Enter ID and new state (visible, invisible, disabled or enabled): ";
+                std::cin >> id >> state;
+                try {
+                    changeControlState(controls, id, parseControlState(state));
+                } catch (const std::invalid_argument& e) {
+                    std::cout << e.what() << std::endl;
+                }
+                break;
+            }
+
             case 0:
                 std::cout << "Exiting program." << std::endl;
                 break;
@@ -159,4 +475,3 @@ int main() {
 
     return 0;
 }
-
@@ -1,27 +1,554 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <unordered_set>
 #include <algorithm>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <array>
+#include <stdexcept>
+#include <tuple>
+#include <memory>
+#include <cmath>
+
+enum class WidgetKind : uint8_t {
+    Dynamic,
+    Static
+};
+
+// FNV-1a over every character of a name
+constexpr uint32_t fnv1a(std::string_view name) {
+    uint32_t h = 2166136261u;
+    for (char c : name) {
+        h = (h ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return h;
+}
+
+// Key for a perfect hash lookup. The cheap key only reads the length and three characters, as
+// gperf does; the full key hashes every character (FNV-1a) and is used when the cheap key
+// cannot tell two names apart.
+constexpr uint32_t perfectHashKey(std::string_view name, bool fullKey) {
+    if (!fullKey) {
+        if (name.empty()) {
+            return 0;
+        }
+        return static_cast<uint32_t>(name.size()) ^ static_cast<uint8_t>(name[0]) << 8 ^
+               static_cast<uint8_t>(name[name.size() / 2]) << 16 ^ static_cast<uint32_t>(static_cast<uint8_t>(name.back())) << 24;
+    }
+    return fnv1a(name);
+}
+
+// Read-only lookup table for a set of names fixed at build time. makePerfectHashTable searches
+// for a multiplier that puts every name in its own slot, so a lookup is a few character reads,
+// a multiply and shift, one slot read and one string compare, with no probing. Built as a
+// constexpr value, the table lives in read-only data and needs no construction at startup.
+template <size_t N>
+class PerfectHashTable {
+    static_assert(N > 0 && N < 255, "slots hold one-byte name indexes");
+
+public:
+    static constexpr size_t npos = ~size_t(0);
+
+    // Power of two, at least twice the names, so a multiplier is found after a few tries
+    static constexpr unsigned slotBits() {
+        unsigned bits = 1;
+        while ((size_t(1) << bits) < 2 * N) {
+            bits++;
+        }
+        return bits;
+    }
+
+    static constexpr size_t slotCount() { return size_t(1) << slotBits(); }
+
+    // Position of the name in the original list, or npos
+    constexpr size_t find(std::string_view name) const {
+        uint8_t index = slots[slotOf(name)];
+        return index < N && names[index] == name ? index : npos;
+    }
+
+    constexpr bool contains(std::string_view name) const { return find(name) != npos; }
+
+    constexpr std::string_view operator[](size_t index) const { return names[index]; }
+    static constexpr size_t size() { return N; }
+
+    template <size_t M>
+    friend constexpr PerfectHashTable<M> makePerfectHashTable(const std::string_view (&names)[M]);
+
+private:
+    constexpr size_t slotOf(std::string_view name) const {
+        return (perfectHashKey(name, fullKey) * multiplier) >> (32 - slotBits());
+    }
+
+    uint32_t multiplier = 0;
+    bool fullKey = false;
+    std::array<uint8_t, slotCount()> slots{};   // Name index per slot, N if empty
+    std::array<std::string_view, N> names{};
+};
+
+// Build the table, trying multipliers until no two names share a slot. Evaluated at compile
+// time the throws become compile errors.
+template <size_t N>
+constexpr PerfectHashTable<N> makePerfectHashTable(const std::string_view (&names)[N]) {
+    PerfectHashTable<N> table;
+    for (size_t i = 0; i < N; ++i) {
+        if (names[i].empty()) {
+            throw std::invalid_argument("empty name in a perfect hash table");
+        }
+        for (size_t j = i + 1; j < N; ++j) {
+            if (names[i] == names[j]) {
+                throw std::invalid_argument("duplicate name in a perfect hash table");
+            }
+            if (perfectHashKey(names[i], false) == perfectHashKey(names[j], false)) {
+                table.fullKey = true;
+            }
+        }
+        table.names[i] = names[i];
+    }
+    for (uint32_t multiplier = 0x9E3779B1u, tries = 0; tries < 100000; multiplier += 0x6D2B79F6u, ++tries) {
+        table.multiplier = multiplier;
+        bool collision = false;
+        for (size_t slot = 0; slot < table.slotCount(); ++slot) {
+            table.slots[slot] = N;
+        }
+        for (size_t i = 0; i < N && !collision; ++i) {
+            uint8_t& slot = table.slots[table.slotOf(names[i])];
+            collision = slot != N;
+            slot = static_cast<uint8_t>(i);
+        }
+        if (!collision) {
+            return table;
+        }
+    }
+    throw std::logic_error("no perfect hash multiplier found");
+}
+
+// The static widgets are known at build time
+constexpr std::string_view kStaticWidgetNames[] = {"Logo", "WarningLights", "BatteryStatus"};
+constexpr auto kStaticWidgets = makePerfectHashTable(kStaticWidgetNames);
+static_assert(kStaticWidgets.contains("WarningLights") && !kStaticWidgets.contains("Speedometer"),
+              "static widget table");
+
+// All widgets, dynamic and static, held once. Names are interned into one character arena, so
+// each distinct name is stored once however often it is added. An open-addressing table (linear
+// probing, power-of-two capacity, at most half full) maps a name to its widget id, and stores the
+// name hashes next to the ids so a probe only compares strings when the hashes match.
+// The combined list is a view over both kinds: nothing is copied to iterate it.
+class WidgetCatalog {
+    struct Entry {
+        uint32_t offset;   // Name position in the arena
+        uint32_t length;
+        WidgetKind kind;
+    };
+
+    std::string arena;                  // Every name, back to back
+    std::vector<Entry> entries;         // By widget id
+    std::vector<uint32_t> dynamicIds;   // In insertion order
+    std::vector<uint32_t> staticIds;    // Sorted by name
+    std::vector<uint32_t> slots;        // Widget id per slot, or kEmpty
+    std::vector<uint32_t> slotHashes;
+
+    static constexpr uint32_t kEmpty = ~uint32_t(0);
+
+    static uint32_t hash(std::string_view name) { return fnv1a(name); }
+
+    // Slot holding the name, or the empty slot where it would go
+    size_t probe(std::string_view name, uint32_t h) const {
+        size_t mask = slots.size() - 1;
+        for (size_t slot = h & mask;; slot = (slot + 1) & mask) {
+            if (slots[slot] == kEmpty || (slotHashes[slot] == h && this->name(slots[slot]) == name)) {
+                return slot;
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<uint32_t> oldSlots = std::move(slots);
+        std::vector<uint32_t> oldHashes = std::move(slotHashes);
+        slots.assign(std::max<size_t>(16, oldSlots.size() * 2), kEmpty);
+        slotHashes.assign(slots.size(), 0);
+        size_t mask = slots.size() - 1;
+        for (size_t i = 0; i < oldSlots.size(); ++i) {
+            if (oldSlots[i] != kEmpty) {
+                size_t slot = oldHashes[i] & mask;
+                while (slots[slot] != kEmpty) {
+                    slot = (slot + 1) & mask;
+                }
+                slots[slot] = oldSlots[i];
+                slotHashes[slot] = oldHashes[i];
+            }
+        }
+    }
+
+public:
+    static constexpr uint32_t npos = kEmpty;
+
+    // A list of widget ids seen as names
+    class View {
+        const WidgetCatalog* catalog;
+        const std::vector<uint32_t>* first;
+        const std::vector<uint32_t>* second;
+
+    public:
+        class iterator {
+            const View* view;
+            size_t index;
+
+        public:
+            iterator(const View* view, size_t index) : view(view), index(index) {}
+            std::string_view operator*() const { return view->catalog->name((*view)[index]); }
+            iterator& operator++() { ++index; return *this; }
+            bool operator!=(const iterator& other) const { return index != other.index; }
+        };
+
+        View(const WidgetCatalog* catalog, const std::vector<uint32_t>* first, const std::vector<uint32_t>* second)
+            : catalog(catalog), first(first), second(second) {}
+
+        size_t size() const { return first->size() + (second ? second->size() : 0); }
+        uint32_t operator[](size_t i) const { return i < first->size() ? (*first)[i] : (*second)[i - first->size()]; }
+        iterator begin() const { return iterator(this, 0); }
+        iterator end() const { return iterator(this, size()); }
+    };
+
+    WidgetCatalog() { grow(); }
+
+    // Add a widget and return its id; a name already in the catalog keeps its id and kind
+    uint32_t add(std::string_view name, WidgetKind kind) {
+        uint32_t h = hash(name);
+        size_t slot = probe(name, h);
+        if (slots[slot] != kEmpty) {
+            return slots[slot];
+        }
+        uint32_t id = static_cast<uint32_t>(entries.size());
+        entries.push_back({static_cast<uint32_t>(arena.size()), static_cast<uint32_t>(name.size()), kind});
+        arena.append(name);
+        slots[slot] = id;
+        slotHashes[slot] = h;
+        if (kind == WidgetKind::Dynamic) {
+            dynamicIds.push_back(id);
+        } else {
+            auto position = std::lower_bound(staticIds.begin(), staticIds.end(), name,
+                                             [this](uint32_t other, std::string_view value) { return this->name(other) < value; });
+            staticIds.insert(position, id);
+        }
+        if (entries.size() * 2 > slots.size()) {
+            grow();
+        }
+        return id;
+    }
+
+    // Widget id for a name, or npos
+    uint32_t find(std::string_view name) const {
+        return slots[probe(name, hash(name))];
+    }
+
+    bool contains(std::string_view name) const { return find(name) != npos; }
+
+    bool contains(std::string_view name, WidgetKind kind) const {
+        uint32_t id = find(name);
+        return id != npos && entries[id].kind == kind;
+    }
+
+    // Valid until the next add
+    std::string_view name(uint32_t id) const {
+        return std::string_view(arena.data() + entries[id].offset, entries[id].length);
+    }
+
+    WidgetKind kind(uint32_t id) const { return entries[id].kind; }
+    size_t size() const { return entries.size(); }
+
+    View dynamicWidgets() const { return View(this, &dynamicIds, nullptr); }
+    View staticWidgets() const { return View(this, &staticIds, nullptr); }
+
+    // Dynamic widgets in insertion order, then static widgets by name
+    View allWidgets() const { return View(this, &dynamicIds, &staticIds); }
+
+    size_t memoryUsage() const {
+        return arena.capacity() + entries.capacity() * sizeof(Entry) +
+               (dynamicIds.capacity() + staticIds.capacity() + slots.capacity() + slotHashes.capacity()) * sizeof(uint32_t);
+    }
+};
+
+// Vehicle signals the dynamic widgets follow
+struct VehicleSignals {
+    float speed;     // km/h
+    float rpm;
+    float fuel;      // %
+    float coolant;   // Celsius
+};
+
+// Dynamic widgets. Each type has its catalog name, a unit and an update step that eases the
+// shown value towards the signal.
+struct Speedometer {
+    static constexpr const char* kName = "Speedometer";
+    static constexpr const char* kUnit = "km/h";
+    float shown = 0;
+
+    void update(const VehicleSignals& signals, float dt) { shown += (signals.speed - shown) * std::min(1.0f, dt * 8); }
+    float value() const { return shown; }
+};
+
+struct Tachometer {
+    static constexpr const char* kName = "Tachometer";
+    static constexpr const char* kUnit = "rpm";
+    float shown = 0;
+
+    void update(const VehicleSignals& signals, float dt) { shown += (signals.rpm - shown) * std::min(1.0f, dt * 12); }
+    float value() const { return shown; }
+};
+
+struct FuelGauge {
+    static constexpr const char* kName = "FuelGauge";
+    static constexpr const char* kUnit = "%";
+    float shown = 0;
+
+    void update(const VehicleSignals& signals, float dt) { shown += (signals.fuel - shown) * std::min(1.0f, dt * 2); }
+    float value() const { return shown; }
+};
+
+struct TemperatureMeter {
+    static constexpr const char* kName = "TemperatureMeter";
+    static constexpr const char* kUnit = "C";
+    float shown = 0;
+
+    void update(const VehicleSignals& signals, float dt) { shown += (signals.coolant - shown) * std::min(1.0f, dt); }
+    float value() const { return shown; }
+};
+
+// Refers to a widget in a pool. The generation is odd while the slot is live and moves on
+// when the widget is destroyed, so stale handles are detected instead of reaching a new widget.
+template <typename T>
+struct WidgetHandle {
+    uint32_t slot = ~uint32_t(0);
+    uint32_t generation = 0;
+};
+
+// Fixed-capacity pool of one widget type. Storage is allocated once, when the pool is built;
+// creating and destroying widgets after that never touches the heap. Live widgets are kept
+// dense (a destroyed widget is replaced by the last one), so an update pass walks one
+// contiguous array; handles go through a slot table that follows the moves.
+template <typename T>
+class WidgetPool {
+    struct Slot {
+        uint32_t index = 0;        // Position in widgets while live
+        uint32_t generation = 0;   // Odd while live
+    };
+
+    std::vector<T> widgets;              // Live widgets, contiguous
+    std::vector<uint32_t> slotOfWidget;  // Parallel to widgets
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+
+public:
+    using value_type = T;
+
+    explicit WidgetPool(size_t capacity) : slots(capacity) {
+        widgets.reserve(capacity);
+        slotOfWidget.reserve(capacity);
+        freeSlots.reserve(capacity);
+        for (size_t slot = capacity; slot-- > 0;) {
+            freeSlots.push_back(static_cast<uint32_t>(slot));
+        }
+    }
+
+    template <typename... Args>
+    WidgetHandle<T> create(Args&&... args) {
+        if (freeSlots.empty()) {
+            throw std::length_error(std::string(T::kName) + " pool is full");
+        }
+        uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        slots[slot].index = static_cast<uint32_t>(widgets.size());
+        slots[slot].generation++;
+        widgets.push_back(T{std::forward<Args>(args)...});
+        slotOfWidget.push_back(slot);
+        return {slot, slots[slot].generation};
+    }
+
+    // False if the handle is stale
+    bool destroy(WidgetHandle<T> handle) {
+        if (!alive(handle)) {
+            return false;
+        }
+        uint32_t index = slots[handle.slot].index;
+        if (index + 1 != widgets.size()) {
+            widgets[index] = std::move(widgets.back());
+            slotOfWidget[index] = slotOfWidget.back();
+            slots[slotOfWidget[index]].index = index;
+        }
+        widgets.pop_back();
+        slotOfWidget.pop_back();
+        slots[handle.slot].generation++;
+        freeSlots.push_back(handle.slot);
+        return true;
+    }
+
+    bool alive(WidgetHandle<T> handle) const {
+        return handle.slot < slots.size() && handle.generation % 2 == 1 && slots[handle.slot].generation == handle.generation;
+    }
+
+    // nullptr if the handle is stale; valid until the next destroy
+    T* get(WidgetHandle<T> handle) {
+        return alive(handle) ? &widgets[slots[handle.slot].index] : nullptr;
+    }
+
+    // Handle of the widget at a position in the live array
+    WidgetHandle<T> handleAt(size_t index) const {
+        uint32_t slot = slotOfWidget[index];
+        return {slot, slots[slot].generation};
+    }
+
+    void clear() {
+        while (!widgets.empty()) {
+            uint32_t slot = slotOfWidget.back();
+            destroy({slot, slots[slot].generation});
+        }
+    }
+
+    size_t size() const { return widgets.size(); }
+    size_t capacity() const { return slots.size(); }
+    T* begin() { return widgets.data(); }
+    T* end() { return widgets.data() + widgets.size(); }
+    const T* begin() const { return widgets.data(); }
+    const T* end() const { return widgets.data() + widgets.size(); }
+};
+
+// The dynamic widgets of the cluster, one pool per type
+template <typename... Widgets>
+class WidgetLifecycle {
+    std::tuple<WidgetPool<Widgets>...> pools;
+
+public:
+    explicit WidgetLifecycle(size_t capacityPerType) : pools(WidgetPool<Widgets>(capacityPerType)...) {}
+
+    template <typename T>
+    WidgetPool<T>& pool() { return std::get<WidgetPool<T>>(pools); }
+
+    template <typename T>
+    const WidgetPool<T>& pool() const { return std::get<WidgetPool<T>>(pools); }
+
+    template <typename T, typename... Args>
+    WidgetHandle<T> create(Args&&... args) { return pool<T>().create(std::forward<Args>(args)...); }
+
+    template <typename T>
+    bool destroy(WidgetHandle<T> handle) { return pool<T>().destroy(handle); }
+
+    // Call f with each pool, in type order
+    template <typename F>
+    void forEachPool(F f) { (f(pool<Widgets>()), ...); }
+
+    template <typename F>
+    void forEachPool(F f) const { (f(pool<Widgets>()), ...); }
+
+    // One update pass: every live widget of a type, contiguously, type after type
+    void update(const VehicleSignals& signals, float dt) {
+        forEachPool([&](auto& widgets) {
+            for (auto& widget : widgets) {
+                widget.update(signals, dt);
+            }
+        });
+    }
+
+    size_t size() const {
+        size_t live = 0;
+        forEachPool([&](const auto& widgets) { live += widgets.size(); });
+        return live;
+    }
+
+    void clear() {
+        forEachPool([](auto& widgets) { widgets.clear(); });
+    }
+};
+
+using ClusterWidgets = WidgetLifecycle<Speedometer, Tachometer, FuelGauge, TemperatureMeter>;
 
 // Function to print all dynamic widgets using an iterator
-void printDynamicWidgets(const std::vector<std::string>& dynamicWidgets) {
+void printDynamicWidgets(const WidgetCatalog& catalog) {
     std::cout << "Dynamic Widgets: " << std::endl;
+    WidgetCatalog::View dynamicWidgets = catalog.dynamicWidgets();
     for (auto it = dynamicWidgets.begin(); it != dynamicWidgets.end(); ++it) {
         std::cout << *it << std::endl;
     }
 }
 
-// Function to find a specific widget in the set (e.g., "WarningLights")
-void findStaticWidget(const std::set<std::string>& staticWidgets, const std::string& widget) {
-    auto found = staticWidgets.find(widget);
-    if (found != staticWidgets.end()) {
+// Function to find a specific widget among the static widgets (e.g., "WarningLights")
+void findStaticWidget(const std::string& widget) {
+    if (kStaticWidgets.contains(widget)) {
         std::cout << "\"" << widget << "\" is found in static widgets." << std::endl;
     } else {
         std::cout << "\"" << widget << "\" is NOT found in static widgets." << std::endl;
     }
 }
 
-// Function to combine dynamic and static widgets into a single vector
+// Function to find a widget in the combined list
+void findWidgetInCombinedList(const WidgetCatalog& catalog, const std::string& widget) {
+    if (catalog.contains(widget)) {
+        std::cout << "\"" << widget << "\" is found in the combined widget list." << std::endl;
+    } else {
+        std::cout << "\"" << widget << "\" is NOT found in the combined widget list." << std::endl;
+    }
+}
+
+// Function to create a live dynamic widget from its type name
+void createDynamicWidget(ClusterWidgets& widgets, const std::string& name) {
+    bool known = false;
+    widgets.forEachPool([&](auto& pool) {
+        using Widget = typename std::decay_t<decltype(pool)>::value_type;
+        if (name == Widget::kName) {
+            known = true;
+            WidgetHandle<Widget> handle = pool.create();
+            std::cout << "Created " << name << " (handle " << handle.slot << " " << handle.generation << ", "
+                      << pool.size() << " live of " << pool.capacity() << ")." << std::endl;
+        }
+    });
+    if (!known) {
+        std::cout << "\"" << name << "\" is not a dynamic widget type." << std::endl;
+    }
+}
+
+// Function to destroy a live dynamic widget by its handle
+void destroyDynamicWidget(ClusterWidgets& widgets, const std::string& name, uint32_t slot, uint32_t generation) {
+    bool destroyed = false;
+    widgets.forEachPool([&](auto& pool) {
+        using Widget = typename std::decay_t<decltype(pool)>::value_type;
+        if (name == Widget::kName) {
+            destroyed = pool.destroy(WidgetHandle<Widget>{slot, generation});
+        }
+    });
+    if (destroyed) {
+        std::cout << "Destroyed " << name << " (handle " << slot << " " << generation << ")." << std::endl;
+    } else {
+        std::cout << "No live " << name << " with handle " << slot << " " << generation << "." << std::endl;
+    }
+}
+
+// Function to run one update pass and print the live dynamic widgets
+void updateLiveWidgets(ClusterWidgets& widgets, const VehicleSignals& signals) {
+    widgets.update(signals, 0.1f);
+    std::cout << "Live widgets (" << widgets.size() << "): " << std::endl;
+    widgets.forEachPool([](const auto& pool) {
+        using Widget = typename std::decay_t<decltype(pool)>::value_type;
+        for (size_t i = 0; i < pool.size(); ++i) {
+            WidgetHandle<Widget> handle = pool.handleAt(i);
+            std::cout << Widget::kName << " (handle " << handle.slot << " " << handle.generation << "): "
+                      << static_cast<int>(pool.begin()[i].value()) << " " << Widget::kUnit << std::endl;
+        }
+    });
+}
+
+// Function to print all widgets (combined list)
+void printAllWidgets(const WidgetCatalog& catalog) {
+    std::cout << "All Widgets: " << std::endl;
+    for (std::string_view widget : catalog.allWidgets()) {
+        std::cout << widget << std::endl;
+    }
+}
+
+// The previous approach, kept as the baseline for --bench: copy both containers into a new
+// vector and scan it for every query
 std::vector<std::string> combineWidgets(const std::vector<std::string>& dynamicWidgets, const std::set<std::string>& staticWidgets) {
     std::vector<std::string> allWidgets;
     std::copy(dynamicWidgets.begin(), dynamicWidgets.end(), std::back_inserter(allWidgets));
@@ -29,32 +556,288 @@ std::vector<std::string> combineWidgets(const std::vector<std::string>& dynamicW
     return allWidgets;
 }
 
-// Function to find a widget in the combined vector
-void findWidgetInCombinedList(const std::vector<std::string>& combinedWidgets, const std::string& widget) {
-    auto it = std::find(combinedWidgets.begin(), combinedWidgets.end(), widget);
-    if (it != combinedWidgets.end()) {
-        std::cout << "\"" << widget << "\" is found in the combined widget list." << std::endl;
-    } else {
-        std::cout << "\"" << widget << "\" is NOT found in the combined widget list." << std::endl;
+// Membership queries on a cluster display with a few thousand widgets: combine-and-scan per
+// query against the catalog
+void benchmarkCatalog() {
+    using Clock = std::chrono::steady_clock;
+    using Micro = std::chrono::duration<double, std::micro>;
+    const size_t dynamicCount = 4000;
+    const size_t staticCount = 1000;
+    const size_t queryCount = 2000;
+    std::mt19937 gen(42);
+
+    std::vector<std::string> dynamicWidgets;
+    std::set<std::string> staticWidgets;
+    WidgetCatalog catalog;
+    for (size_t i = 0; i < dynamicCount; ++i) {
+        dynamicWidgets.push_back("Gauge" + std::to_string(i));
+        catalog.add(dynamicWidgets.back(), WidgetKind::Dynamic);
     }
+    for (size_t i = 0; i < staticCount; ++i) {
+        staticWidgets.insert("Indicator" + std::to_string(i));
+        catalog.add("Indicator" + std::to_string(i), WidgetKind::Static);
+    }
+    // Half the queries hit, half miss
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < queryCount; ++i) {
+        size_t n = gen() % (dynamicCount + staticCount);
+        std::string name = n < dynamicCount ? "Gauge" + std::to_string(n) : "Indicator" + std::to_string(n - dynamicCount);
+        queries.push_back(i % 2 ? name : name + "X");
+    }
+
+    auto start = Clock::now();
+    size_t vectorHits = 0;
+    size_t copiedStrings = 0;
+    for (const std::string& query : queries) {
+        std::vector<std::string> allWidgets = combineWidgets(dynamicWidgets, staticWidgets);
+        copiedStrings += allWidgets.size();
+        vectorHits += std::find(allWidgets.begin(), allWidgets.end(), query) != allWidgets.end();
+    }
+    double vectorUs = Micro(Clock::now() - start).count();
+
+    start = Clock::now();
+    size_t catalogHits = 0;
+    for (const std::string& query : queries) {
+        catalogHits += catalog.contains(query);
+    }
+    double catalogUs = Micro(Clock::now() - start).count();
+
+    size_t viewed = 0;
+    start = Clock::now();
+    for (std::string_view widget : catalog.allWidgets()) {
+        viewed += widget.size();
+    }
+    double viewUs = Micro(Clock::now() - start).count();
+
+    std::cout << queryCount << " lookups among " << catalog.size() << " widgets: " << vectorUs / queryCount
+              << " us each with combine + find (" << copiedStrings << " strings copied), " << catalogUs * 1000 / queryCount
+              << " ns each with the catalog" << (vectorHits == catalogHits ? "" : " (MISMATCH)") << std::endl;
+    std::cout << "Combined view walked in " << viewUs << " us (" << viewed << " characters, no copies); catalog uses "
+              << catalog.memoryUsage() / 1024 << " KiB" << std::endl;
 }
 
-// Function to print all widgets (combined list)
-void printAllWidgets(const std::vector<std::string>& allWidgets) {
-    std::cout << "All Widgets: " << std::endl;
-    for (const auto& widget : allWidgets) {
-        std::cout << widget << std::endl;
+// Allocator that counts the bytes it hands out, to measure container footprints
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    size_t* bytes;
+
+    explicit CountingAllocator(size_t* bytes) : bytes(bytes) {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : bytes(other.bytes) {}
+
+    T* allocate(size_t n) {
+        *bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        *bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const { return bytes == other.bytes; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>& other) const { return bytes != other.bytes; }
+};
+
+// Static widget lookups (a mix of hits and misses) in the compile-time table against the
+// std::set it replaces and an std::unordered_set, with the memory each one needs
+void benchmarkStaticLookup() {
+    using Clock = std::chrono::steady_clock;
+    using Nano = std::chrono::duration<double, std::nano>;
+    const size_t lookups = 10000000;
+
+    size_t setBytes = 0;
+    size_t hashSetBytes = 0;
+    std::set<std::string, std::less<std::string>, CountingAllocator<std::string>> staticSet{
+        std::less<std::string>(), CountingAllocator<std::string>(&setBytes)};
+    std::unordered_set<std::string, std::hash<std::string>, std::equal_to<std::string>, CountingAllocator<std::string>>
+        staticHashSet(0, std::hash<std::string>(), std::equal_to<std::string>(), CountingAllocator<std::string>(&hashSetBytes));
+    for (std::string_view name : kStaticWidgetNames) {
+        staticSet.emplace(name);
+        staticHashSet.emplace(name);
     }
+
+    std::vector<std::string> queries = {"Logo", "Speedometer", "WarningLights", "Tachometer", "BatteryStatus",
+                                        "FuelGauge", "TemperatureMeter", "Warning", "LogoX", "Clock"};
+    auto time = [&](auto contains) {
+        size_t hits = 0;
+        size_t query = 0;
+        auto start = Clock::now();
+        for (size_t i = 0; i < lookups; ++i) {
+            hits += contains(queries[query]);
+            query = query + 1 == queries.size() ? 0 : query + 1;
+        }
+        return std::make_pair(Nano(Clock::now() - start).count() / lookups, hits);
+    };
+    auto set = time([&](const std::string& name) { return staticSet.find(name) != staticSet.end(); });
+    auto hashSet = time([&](const std::string& name) { return staticHashSet.find(name) != staticHashSet.end(); });
+    auto table = time([](const std::string& name) { return kStaticWidgets.contains(name); });
+
+    size_t nameBytes = 0;
+    for (std::string_view name : kStaticWidgetNames) {
+        nameBytes += name.size() + 1;
+    }
+    std::cout << "Static widget lookup: " << set.first << " ns with std::set, " << hashSet.first
+              << " ns with std::unordered_set, " << table.first << " ns with the perfect hash table"
+              << (set.second == table.second && hashSet.second == table.second ? "" : " (MISMATCH)") << std::endl;
+    // Data only: the code each variant pulls in (set and hash table templates) is not measurable from
+    // inside the program, so compare .text/.rodata of builds that use one variant each
+    std::cout << "Data footprint: std::set " << sizeof(staticSet) + setBytes << " bytes (" << setBytes
+              << " on the heap), std::unordered_set " << sizeof(staticHashSet) + hashSetBytes << " bytes (" << hashSetBytes
+              << " on the heap), both built at startup; perfect hash table " << sizeof(kStaticWidgets) + nameBytes
+              << " bytes of read-only data (" << kStaticWidgets.slotCount() << " one-byte slots), none on the heap"
+              << std::endl;
+}
+
+// Heap-allocated widgets behind a virtual update, the usual alternative to the pools
+struct HeapWidget {
+    virtual ~HeapWidget() = default;
+    virtual void update(const VehicleSignals& signals, float dt) = 0;
+    virtual float value() const = 0;
+};
+
+template <typename T>
+struct HeapWidgetOf : HeapWidget {
+    T widget;
+    void update(const VehicleSignals& signals, float dt) override { widget.update(signals, dt); }
+    float value() const override { return widget.value(); }
+};
+
+// Screen transitions: each one destroys the previous screen's widgets in a shuffled order,
+// creates a few hundred new ones of mixed types and runs update passes over them. Pools against
+// one heap allocation per widget with virtual updates.
+void benchmarkLifecycle() {
+    using Clock = std::chrono::steady_clock;
+    using Milli = std::chrono::duration<double, std::milli>;
+    const size_t transitions = 5000;
+    const size_t perScreen = 300;
+    const size_t passes = 10;
+    const VehicleSignals signals{80.0f, 2400.0f, 65.0f, 90.0f};
+    std::mt19937 gen(42);
+
+    std::vector<uint8_t> types(perScreen);
+    std::vector<size_t> order(perScreen);
+    for (size_t i = 0; i < perScreen; ++i) {
+        types[i] = static_cast<uint8_t>(gen() % 4);
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), gen);
+
+    auto start = Clock::now();
+    double heapSum = 0;
+    std::vector<std::unique_ptr<HeapWidget>> screen;
+    for (size_t t = 0; t < transitions; ++t) {
+        if (t > 0) {
+            for (size_t i : order) {
+                screen[i].reset();
+            }
+        }
+        screen.clear();
+        for (uint8_t type : types) {
+            switch (type) {
+                case 0: screen.push_back(std::make_unique<HeapWidgetOf<Speedometer>>()); break;
+                case 1: screen.push_back(std::make_unique<HeapWidgetOf<Tachometer>>()); break;
+                case 2: screen.push_back(std::make_unique<HeapWidgetOf<FuelGauge>>()); break;
+                default: screen.push_back(std::make_unique<HeapWidgetOf<TemperatureMeter>>()); break;
+            }
+        }
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (auto& widget : screen) {
+                widget->update(signals, 0.1f);
+            }
+        }
+        for (const auto& widget : screen) {
+            heapSum += widget->value();
+        }
+    }
+    double heapMs = Milli(Clock::now() - start).count();
+
+    ClusterWidgets widgets(perScreen);
+    std::vector<WidgetHandle<Speedometer>> speedometers;
+    std::vector<WidgetHandle<Tachometer>> tachometers;
+    std::vector<WidgetHandle<FuelGauge>> fuelGauges;
+    std::vector<WidgetHandle<TemperatureMeter>> temperatureMeters;
+    std::vector<uint32_t> handleOf(perScreen);   // Position in the vector of its type
+    speedometers.reserve(perScreen);
+    tachometers.reserve(perScreen);
+    fuelGauges.reserve(perScreen);
+    temperatureMeters.reserve(perScreen);
+
+    start = Clock::now();
+    double poolSum = 0;
+    for (size_t t = 0; t < transitions; ++t) {
+        if (t > 0) {
+            for (size_t i : order) {
+                switch (types[i]) {
+                    case 0: widgets.destroy(speedometers[handleOf[i]]); break;
+                    case 1: widgets.destroy(tachometers[handleOf[i]]); break;
+                    case 2: widgets.destroy(fuelGauges[handleOf[i]]); break;
+                    default: widgets.destroy(temperatureMeters[handleOf[i]]); break;
+                }
+            }
+        }
+        speedometers.clear();
+        tachometers.clear();
+        fuelGauges.clear();
+        temperatureMeters.clear();
+        for (size_t i = 0; i < perScreen; ++i) {
+            switch (types[i]) {
+                case 0: handleOf[i] = speedometers.size(); speedometers.push_back(widgets.create<Speedometer>()); break;
+                case 1: handleOf[i] = tachometers.size(); tachometers.push_back(widgets.create<Tachometer>()); break;
+                case 2: handleOf[i] = fuelGauges.size(); fuelGauges.push_back(widgets.create<FuelGauge>()); break;
+                default: handleOf[i] = temperatureMeters.size(); temperatureMeters.push_back(widgets.create<TemperatureMeter>()); break;
+            }
+        }
+        for (size_t pass = 0; pass < passes; ++pass) {
+            widgets.update(signals, 0.1f);
+        }
+        widgets.forEachPool([&](const auto& pool) {
+            for (const auto& widget : pool) {
+                poolSum += widget.value();
+            }
+        });
+    }
+    double poolMs = Milli(Clock::now() - start).count();
+
+    std::cout << transitions << " screen transitions of " << perScreen << " widgets with " << passes
+              << " update passes: " << heapMs << " ms with heap widgets (" << transitions * perScreen
+              << " allocations), " << poolMs << " ms with pools (no allocations after startup)"
+              << (std::abs(heapSum - poolSum) <= 1e-6 * std::abs(heapSum) ? "" : " (MISMATCH)") << std::endl;
+}
+
+void runBenchmark() {
+    benchmarkCatalog();
+    benchmarkStaticLookup();
+    benchmarkLifecycle();
 }
 
 // Main function to interact with the user and perform the chosen operation
-int main() {
-    // Initialize containers
-    std::vector<std::string> dynamicWidgets = {"Speedometer", "Tachometer", "FuelGauge", "TemperatureMeter"};
-    std::set<std::string> staticWidgets = {"Logo", "WarningLights", "BatteryStatus"};
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        runBenchmark();
+        return 0;
+    }
+
+    // Initialize the catalog
+    WidgetCatalog catalog;
+    for (const char* name : {Speedometer::kName, Tachometer::kName, FuelGauge::kName, TemperatureMeter::kName}) {
+        catalog.add(name, WidgetKind::Dynamic);
+    }
+    for (std::string_view name : kStaticWidgetNames) {
+        catalog.add(name, WidgetKind::Static);
+    }
+
+    // Live dynamic widgets, fed with fixed signals
+    ClusterWidgets widgets(64);
+    const VehicleSignals signals{80.0f, 2400.0f, 65.0f, 90.0f};
 
     int choice;
     std::string widgetName;
+    uint32_t slot;
+    uint32_t generation;
 
     do {
         std::cout << "\nSelect an operation:\n";
@@ -63,49 +846,70 @@ int main() {
         std::cout << "3. Combine dynamic and static widgets\n";
         std::cout << "4. Find a widget in the combined list\n";
         std::cout << "5. Print all widgets\n";
+        std::cout << "6. Create a dynamic widget (e.g., Speedometer)\n";
+        std::cout << "7. Destroy a dynamic widget\n";
+        std::cout << "8. Update and print live widgets\n";
         std::cout << "0. Exit\n";
         std::cout << "Enter your choice: ";
-        std::cin >> choice;
+        if (!(std::cin >> choice)) {
+            return 0;
+        }
 
         switch (choice) {
             case 1:
                 // Print dynamic widgets
-                printDynamicWidgets(dynamicWidgets);
+                printDynamicWidgets(catalog);
                 break;
 
             case 2:
                 // Find a static widget
                 std::cout << "Enter the name of the static widget you want to find: ";
                 std::cin >> widgetName;
-                findStaticWidget(staticWidgets, widgetName);
+                findStaticWidget(widgetName);
                 break;
 
             case 3:
-                // Combine dynamic and static widgets
-                {
-                    std::vector<std::string> allWidgets = combineWidgets(dynamicWidgets, staticWidgets);
-                    std::cout << "Dynamic and static widgets have been combined.\n";
-                }
+                // The catalog always holds both kinds; the combined list is a view over it
+                std::cout << "Dynamic and static widgets have been combined (" << catalog.allWidgets().size()
+                          << " widgets).\n";
                 break;
 
             case 4:
                 // Find a widget in the combined list
-                {
-                    std::vector<std::string> allWidgets = combineWidgets(dynamicWidgets, staticWidgets);
-                    std::cout << "Enter the name of the widget you want to find in the combined list: ";
-                    std::cin >> widgetName;
-                    findWidgetInCombinedList(allWidgets, widgetName);
-                }
+                std::cout << "Enter the name of the widget you want to find in the combined list: ";
+                std::cin >> widgetName;
+                findWidgetInCombinedList(catalog, widgetName);
                 break;
 
             case 5:
                 // Print all widgets
-                {
-                    std::vector<std::string> allWidgets = combineWidgets(dynamicWidgets, staticWidgets);
-                    printAllWidgets(allWidgets);
+                printAllWidgets(catalog);
+                break;
+
+            case 6:
+                // Create a dynamic widget
+                std::cout << "Enter the type of the dynamic widget you want to create: ";
+                std::cin >> widgetName;
+                try {
+                    createDynamicWidget(widgets, widgetName);
+                } catch (const std::exception& e) {
+                    std::cout << "Error: " << e.what() << std::endl;
                 }
                 break;
 
+            case 7:
+                // Destroy a dynamic widget
+                std::cout << "Enter the type and handle of the widget to destroy (e.g., Speedometer 0 1): ";
+                if (std::cin >> widgetName >> slot >> generation) {
+                    destroyDynamicWidget(widgets, widgetName, slot, generation);
+                }
+                break;
+
+            case 8:
+                // Update and print live widgets
+                updateLiveWidgets(widgets, signals);
+                break;
+
             case 0:
                 std::cout << "Exiting program...\n";
                 break;
@@ -116,4 +920,4 @@ int main() {
     } while (choice != 0);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -3,113 +3,532 @@
 #include <algorithm>
 #include <random>
 #include <string>
-
-struct Control {
-    int id;
-    std::string type;  // "button" or "slider"
-    std::string state; // "visible", "invisible", or "disabled"
-};
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "ControlStore.h"
 
 // Function to print the controls
-void printControls(const std::vector<Control>& controls) {
-    for (const auto& control : controls) {
-        std::cout << "ID: " << control.id << ", Type: " << control.type << ", State: " << control.state << std::endl;
+void printControls(const ControlStore& controls) {
+    for (size_t i = 0; i < controls.size(); ++i) {
+        std::cout << "ID: " << controls.id(i) << ", Type: " << toString(controls.type(i)) << ", State: "
+                  << toString(controls.state(i)) << std::endl;
     }
 }
 
-// 1. Create a backup of the control list
-void createBackup(std::vector<Control>& controls) {
-    std::vector<Control> backup = controls;
+// Undo/redo journal for the control list. Every operation goes through the journal, which
+// appends a compact delta to a byte arena instead of keeping a copy of the list:
+//   state changes   position, old and new state of each changed control (5 bytes each), or,
+//                   when that would outgrow the 1-byte-per-control state column, the state
+//                   columns before and after (copy-on-write, so consecutive records share them)
+//   removal         original position and contents of each removed control (9 bytes each)
+//   reverse         nothing, it is its own inverse
+//   partition       one bit per control: whether it was moved to the front
+//   replace         the list before and after (copy-on-write snapshots that share columns)
+// Undoing or redoing state changes costs O(changes), but recording them diffs the whole state
+// column, even for a small batch; the other records take one pass over the list. A checkpoint is a position in the journal plus a generation that changes whenever
+// redoable records are dropped, so a checkpoint into a dropped branch is rejected.
+class ControlJournal {
+public:
+    struct Checkpoint {
+        size_t position;
+        size_t generation;  // Number of redo tails dropped when the checkpoint was taken
+    };
+
+private:
+    enum RecordKind : uint8_t { StateChanges, StateColumns, Removal, Reverse, Partition, Replace };
+
+    struct RecordHeader {
+        RecordKind kind;
+        uint8_t state;    // Removal and Partition: the state operated on
+        uint32_t count;   // Changed controls, removed controls, partitioned controls, or state column size
+        uint32_t extra;   // StateColumns and Replace: index into snapshots
+    };
+
+    ControlStore& store;
+    std::vector<uint8_t> arena;
+    std::vector<size_t> records;    // Offset of each record in the arena
+    size_t applied = 0;             // Records before this index are applied, the rest can be redone
+    std::vector<std::pair<ControlStore, ControlStore>> snapshots;  // StateColumns and Replace records: before, after
+    std::vector<size_t> droppedFrom;  // Record index at which each dropped redo tail started
+
+    template <typename T>
+    void put(T value) {
+        size_t offset = arena.size();
+        arena.resize(offset + sizeof(T));
+        std::memcpy(arena.data() + offset, &value, sizeof(T));
+    }
+
+    template <typename T>
+    T get(size_t& offset) const {
+        T value;
+        std::memcpy(&value, arena.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    // Start a new record, dropping the records that could have been redone
+    void begin(RecordKind kind, uint8_t state, uint32_t count, uint32_t extra = 0) {
+        for (size_t record = applied; record < records.size(); ++record) {
+            size_t offset = records[record];
+            RecordKind kind = get<RecordHeader>(offset).kind;
+            if (kind == StateColumns || kind == Replace) {
+                snapshots.pop_back();
+            }
+        }
+        if (applied < records.size()) {
+            arena.resize(records[applied]);
+            records.resize(applied);
+            droppedFrom.push_back(applied);
+        }
+        records.push_back(arena.size());
+        applied++;
+        put(RecordHeader{kind, state, count, extra});
+    }
+
+    // Apply (forward) or revert one record
+    void replay(size_t record, bool forward) {
+        size_t offset = records[record];
+        RecordHeader header = get<RecordHeader>(offset);
+        ControlState state = static_cast<ControlState>(header.state);
+        switch (header.kind) {
+            case StateChanges:
+                for (uint32_t i = 0; i < header.count; ++i) {
+                    uint32_t position = get<uint32_t>(offset);
+                    uint8_t states = get<uint8_t>(offset);
+                    store.setState(position, static_cast<ControlState>(forward ? states & 0x0F : states >> 4));
+                }
+                break;
+
+            case Removal:
+                if (forward) {
+                    store.removeState(state);
+                } else {
+                    // Merge the removed controls back in at their original positions
+                    ControlStore merged;
+                    merged.reserve(store.size() + header.count);
+                    size_t kept = 0;
+                    for (uint32_t i = 0; i < header.count; ++i) {
+                        uint32_t position = get<uint32_t>(offset);
+                        int32_t id = get<int32_t>(offset);
+                        ControlType type = static_cast<ControlType>(get<uint8_t>(offset));
+                        while (merged.size() < position) {
+                            merged.push_back(store[kept++]);
+                        }
+                        merged.push_back({id, type, state});
+                    }
+                    while (kept < store.size()) {
+                        merged.push_back(store[kept++]);
+                    }
+                    store = merged;
+                }
+                break;
+
+            case Reverse:
+                store.reverse();
+                break;
+
+            case Partition:
+                if (forward) {
+                    store.partitionState(state);
+                } else {
+                    // Bit i tells whether the control at original position i went to the front;
+                    // the partition is stable, so both halves are still in their original order
+                    ControlStore original;
+                    original.reserve(header.count);
+                    size_t front = 0;
+                    size_t back = store.countState(state);
+                    for (uint32_t word = 0; word * 64 < header.count; ++word) {
+                        uint64_t bits = get<uint64_t>(offset);
+                        for (uint32_t i = word * 64; i < header.count && i < word * 64 + 64; ++i) {
+                            original.push_back(store[(bits >> (i % 64)) & 1 ? front++ : back++]);
+                        }
+                    }
+                    store = original;
+                }
+                break;
+
+            case StateColumns:
+            case Replace:
+                store = forward ? snapshots[header.extra].second : snapshots[header.extra].first;
+                break;
+        }
+    }
+
+public:
+    explicit ControlJournal(ControlStore& store) : store(store) {}
+
+    const ControlStore& controls() const { return store; }
+
+    // Run an operation that only writes states and record the states it changed
+    template <typename Operation>
+    size_t changeStates(Operation operation) {
+        ControlStore before = store;  // Shares the columns: free unless a state is written
+        operation(store);
+        if (store.sharesStatesWith(before)) {
+            return 0;
+        }
+        const uint8_t* oldStates = before.states();
+        const uint8_t* newStates = static_cast<const ControlStore&>(store).states();
+        std::vector<uint32_t> changed;
+        for (size_t i = 0; i < store.size(); ++i) {
+            if (oldStates[i] != newStates[i]) {
+                changed.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        if (changed.size() * (sizeof(uint32_t) + 1) > store.size()) {
+            // Deltas would cost more than the state column: keep the old column, which before
+            // already shares, and the new one
+            begin(StateColumns, 0, static_cast<uint32_t>(store.size()), static_cast<uint32_t>(snapshots.size()));
+            snapshots.emplace_back(before, store);
+        } else if (!changed.empty()) {
+            begin(StateChanges, 0, static_cast<uint32_t>(changed.size()));
+            for (uint32_t i : changed) {
+                put(i);
+                put(static_cast<uint8_t>(oldStates[i] << 4 | newStates[i]));
+            }
+        }
+        return changed.size();
+    }
+
+    size_t applyUpdates(const std::vector<StateUpdate>& updates) {
+        return changeStates([&](ControlStore& controls) { controls.applyUpdates(updates); });
+    }
+
+    size_t removeState(ControlState state) {
+        size_t removed = store.countState(state);
+        if (removed == 0) {
+            return 0;
+        }
+        begin(Removal, static_cast<uint8_t>(state), static_cast<uint32_t>(removed));
+        for (size_t i = store.findFirstState(state); i < store.size(); i = store.findFirstState(state, i + 1)) {
+            put(static_cast<uint32_t>(i));
+            put(static_cast<int32_t>(store.id(i)));
+            put(static_cast<uint8_t>(store.type(i)));
+        }
+        store.removeState(state);
+        return removed;
+    }
+
+    void reverse() {
+        begin(Reverse, 0, 0);
+        store.reverse();
+    }
+
+    size_t partitionState(ControlState state) {
+        begin(Partition, static_cast<uint8_t>(state), static_cast<uint32_t>(store.size()));
+        const uint8_t* states = static_cast<const ControlStore&>(store).states();
+        for (size_t word = 0; word * 64 < store.size(); ++word) {
+            uint64_t bits = 0;
+            for (size_t i = word * 64; i < store.size() && i < word * 64 + 64; ++i) {
+                bits |= uint64_t(states[i] == static_cast<uint8_t>(state)) << (i % 64);
+            }
+            put(bits);
+        }
+        return store.partitionState(state);
+    }
+
+    // Replace the whole list, e.g. with a backup
+    void replace(const ControlStore& contents) {
+        begin(Replace, 0, 0, static_cast<uint32_t>(snapshots.size()));
+        snapshots.emplace_back(store, contents);
+        store = contents;
+    }
+
+    bool undo() {
+        if (applied == 0) {
+            return false;
+        }
+        replay(--applied, false);
+        return true;
+    }
+
+    bool redo() {
+        if (applied == records.size()) {
+            return false;
+        }
+        replay(applied++, true);
+        return true;
+    }
+
+    // The current position, to come back to with rewindTo
+    Checkpoint checkpoint() const { return {applied, droppedFrom.size()}; }
+
+    // Undo or redo until the list is back at a checkpoint; false if the checkpoint was dropped
+    // by an operation after an undo (even if new records have since refilled its position)
+    bool rewindTo(Checkpoint checkpoint) {
+        if (checkpoint.generation > droppedFrom.size() || checkpoint.position > records.size()) {
+            return false;
+        }
+        for (size_t drop = checkpoint.generation; drop < droppedFrom.size(); ++drop) {
+            if (droppedFrom[drop] < checkpoint.position) {
+                return false;
+            }
+        }
+        while (applied > checkpoint.position) {
+            undo();
+        }
+        while (applied < checkpoint.position) {
+            redo();
+        }
+        return true;
+    }
+
+    size_t undoDepth() const { return applied; }
+    size_t redoDepth() const { return records.size() - applied; }
+    // Journal bytes, counting one kept state column per StateColumns record
+    size_t memoryUsage() const {
+        size_t bytes = arena.size() + records.size() * sizeof(size_t);
+        for (size_t offset : records) {
+            RecordHeader header = get<RecordHeader>(offset);
+            if (header.kind == StateColumns) {
+                bytes += header.count;
+            }
+        }
+        return bytes;
+    }
+};
+
+// 1. Create a backup of the control list (a copy-on-write snapshot: nothing is copied until
+// one side changes)
+void createBackup(const ControlStore& controls, ControlStore& backup) {
+    backup = controls;
     std::cout << "\nBackup created:\n";
     printControls(backup);
 }
 
-// 2. Temporarily set all states to "disabled"
-void disableAllControls(std::vector<Control>& controls) {
-    std::fill(controls.begin(), controls.end(), Control{0, "", "disabled"});
+// 2. Temporarily set all states to "disabled" (ids and types are kept; undo to go back)
+void disableAllControls(ControlJournal& journal) {
+    journal.applyUpdates({{ControlFilter(), ControlState::Disabled}});
     std::cout << "\nAll controls are temporarily disabled:\n";
-    printControls(controls);
+    printControls(journal.controls());
 }
 
 // 3. Generate random states ("visible", "invisible", "disabled")
-void generateRandomStates(std::vector<Control>& controls) {
+void generateRandomStates(ControlJournal& journal) {
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dist(0, 2); // 0: "visible", 1: "invisible", 2: "disabled"
+    std::uniform_int_distribution<> dist(0, 2); // 0: visible, 1: invisible, 2: disabled
 
-    std::vector<std::string> states = {"visible", "invisible", "disabled"};
-    
-    std::for_each(controls.begin(), controls.end(), [&](Control& ctrl) {
-        ctrl.state = states[dist(gen)];
+    journal.changeStates([&](ControlStore& controls) {
+        std::generate(controls.states(), controls.states() + controls.size(), [&] {
+            return static_cast<uint8_t>(dist(gen));
+        });
     });
 
     std::cout << "\nRandom states generated for controls:\n";
-    printControls(controls);
+    printControls(journal.controls());
 }
 
 // 4. Transform all sliders to "invisible"
-void transformSliders(std::vector<Control>& controls) {
-    std::transform(controls.begin(), controls.end(), controls.begin(), [](Control& ctrl) {
-        if (ctrl.type == "slider") {
-            ctrl.state = "invisible";
-        }
-        return ctrl;
-    });
+void transformSliders(ControlJournal& journal) {
+    journal.applyUpdates({{ControlFilter().ofType(ControlType::Slider), ControlState::Invisible}});
 
     std::cout << "\nAll sliders are set to invisible:\n";
-    printControls(controls);
+    printControls(journal.controls());
 }
 
 // 5. Replace "disabled" with "enabled" for testing
-void replaceDisabledWithEnabled(std::vector<Control>& controls) {
-    std::replace_if(controls.begin(), controls.end(), [](const Control& ctrl) {
-        return ctrl.state == "disabled";
-    }, Control{0, "", "enabled"});
+void replaceDisabledWithEnabled(ControlJournal& journal) {
+    journal.applyUpdates({{ControlFilter().inState(ControlState::Disabled), ControlState::Enabled}});
 
     std::cout << "\nReplaced 'disabled' with 'enabled' for testing:\n";
-    printControls(controls);
+    printControls(journal.controls());
 }
 
 // 6. Remove invisible controls
-void removeInvisibleControls(std::vector<Control>& controls) {
-    controls.erase(std::remove_if(controls.begin(), controls.end(), [](const Control& ctrl) {
-        return ctrl.state == "invisible";
-    }), controls.end());
+void removeInvisibleControls(ControlJournal& journal) {
+    journal.removeState(ControlState::Invisible);
 
     std::cout << "\nInvisible controls removed:\n";
-    printControls(controls);
+    printControls(journal.controls());
 }
 
 // 7. Reverse the control order (e.g., for debugging)
-void reverseControls(std::vector<Control>& controls) {
-    std::reverse(controls.begin(), controls.end());
+void reverseControls(ControlJournal& journal) {
+    journal.reverse();
     std::cout << "\nControls order reversed:\n";
-    printControls(controls);
+    printControls(journal.controls());
 }
 
 // 8. Partition visible controls together
-void partitionVisibleControls(std::vector<Control>& controls) {
-    std::partition(controls.begin(), controls.end(), [](const Control& ctrl) {
-        return ctrl.state == "visible";
-    });
+void partitionVisibleControls(ControlJournal& journal) {
+    journal.partitionState(ControlState::Visible);
 
     std::cout << "\nVisible controls partitioned:\n";
-    printControls(controls);
+    printControls(journal.controls());
 }
 
-int main() {
-    std::vector<Control> controls = {
-        {1, "button", "visible"},
-        {2, "button", "invisible"},
-        {3, "slider", "visible"},
-        {4, "slider", "disabled"},
-        {5, "button", "disabled"},
-        {6, "button", "visible"},
-        {7, "slider", "invisible"},
-        {8, "slider", "disabled"},
-        {9, "button", "invisible"},
-        {10, "slider", "visible"}
-    };
+// 9. Restore the backup taken with option 1 (itself journaled, so it can be undone)
+void restoreBackup(ControlJournal& journal, const ControlStore& backup) {
+    journal.replace(backup);
+    std::cout << "\nBackup restored:\n";
+    printControls(journal.controls());
+}
+
+// 10./11. Undo or redo the last operation
+void undoOperation(ControlJournal& journal) {
+    if (!journal.undo()) {
+        std::cout << "\nNothing to undo.\n";
+        return;
+    }
+    std::cout << "\nUndone (" << journal.undoDepth() << " more to undo, " << journal.redoDepth()
+              << " to redo, journal " << journal.memoryUsage() << " bytes):\n";
+    printControls(journal.controls());
+}
+
+void redoOperation(ControlJournal& journal) {
+    if (!journal.redo()) {
+        std::cout << "\nNothing to redo.\n";
+        return;
+    }
+    std::cout << "\nRedone (" << journal.undoDepth() << " to undo, " << journal.redoDepth()
+              << " more to redo):\n";
+    printControls(journal.controls());
+}
+
+// 13. Return to the checkpoint set with option 12
+void returnToCheckpoint(ControlJournal& journal, ControlJournal::Checkpoint checkpoint) {
+    if (!journal.rewindTo(checkpoint)) {
+        std::cout << "\nThe checkpoint is no longer in the journal.\n";
+        return;
+    }
+    std::cout << "\nReturned to the checkpoint:\n";
+    printControls(journal.controls());
+}
+
+// The previous control representation, kept as the baseline for --bench
+struct StringControl {
+    int id;
+    std::string type;
+    std::string state;
+};
+
+// A mode switch over a million controls (back up, hide the sliders, disable the rest, then
+// replace disabled with enabled): whole-struct copies and transforms on strings against one
+// batched pass over the state column of a copy-on-write store
+void runBenchmark() {
+    using Clock = std::chrono::steady_clock;
+    using Micro = std::chrono::duration<double, std::micro>;
+    const size_t count = 1000000;
+    const char* typeNames[] = {"button", "slider"};
+    const char* stateNames[] = {"visible", "invisible", "disabled"};
+    std::mt19937 gen(42);
+
+    std::vector<StringControl> strings;
+    ControlStore store;
+    store.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t type = gen() % 2;
+        size_t state = gen() % 3;
+        strings.push_back({static_cast<int>(i), typeNames[type], stateNames[state]});
+        store.push_back({static_cast<int>(i), static_cast<ControlType>(type), static_cast<ControlState>(state)});
+    }
+
+    auto start = Clock::now();
+    std::vector<StringControl> stringBackup = strings;
+    std::transform(strings.begin(), strings.end(), strings.begin(), [](StringControl& ctrl) {
+        if (ctrl.type == "slider") {
+            ctrl.state = "invisible";
+        }
+        return ctrl;
+    });
+    std::replace_if(strings.begin(), strings.end(), [](const StringControl& ctrl) {
+        return ctrl.type == "button";
+    }, StringControl{0, "", "disabled"});
+    std::replace_if(strings.begin(), strings.end(), [](const StringControl& ctrl) {
+        return ctrl.state == "disabled";
+    }, StringControl{0, "", "enabled"});
+    double stringUs = Micro(Clock::now() - start).count();
+
+    std::vector<uint8_t> originalStates(std::as_const(store).states(), std::as_const(store).states() + count);
+    start = Clock::now();
+    ControlStore backup = store;
+    double snapshotUs = Micro(Clock::now() - start).count();
+    start = Clock::now();
+    size_t changed = store.applyUpdates({
+        {ControlFilter().ofType(ControlType::Slider), ControlState::Invisible},
+        {ControlFilter().ofType(ControlType::Button), ControlState::Disabled},
+        {ControlFilter().inState(ControlState::Disabled), ControlState::Enabled},
+    });
+    double batchUs = Micro(Clock::now() - start).count();
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        mismatches += std::string(toString(store.state(i))) != strings[i].state;
+    }
+    // The snapshot shared the state column during the update: it must still hold the original states
+    if (store.sharesStatesWith(backup) ||
+        !std::equal(originalStates.begin(), originalStates.end(), std::as_const(backup).states())) {
+        ++mismatches;
+    }
+    std::cout << "Mode switch over " << count << " controls: " << stringUs << " us with string structs, "
+              << snapshotUs + batchUs << " us with the store (snapshot " << snapshotUs << " us, one batched pass changing "
+              << changed << " states)" << (mismatches == 0 && stringBackup.size() == backup.size() ? "" : " (MISMATCH)")
+              << std::endl;
+
+    // The same list through the journal: a run of operations, then everything undone and redone
+    ControlStore original = store;
+    ControlJournal journal(store);
+    ControlJournal::Checkpoint beforeOperations = journal.checkpoint();
+    start = Clock::now();
+    journal.applyUpdates({{ControlFilter().inState(ControlState::Enabled), ControlState::Visible}});
+    journal.changeStates([&](ControlStore& controls) {
+        for (size_t i = 0; i < controls.size(); i += 100) {
+            controls.setState(i, ControlState::Disabled);
+        }
+    });
+    journal.partitionState(ControlState::Visible);
+    journal.removeState(ControlState::Disabled);
+    journal.reverse();
+    journal.applyUpdates({{ControlFilter().ofType(ControlType::Slider), ControlState::Enabled}});
+    size_t operations = journal.undoDepth();
+    ControlJournal::Checkpoint afterOperations = journal.checkpoint();
+    double recordUs = Micro(Clock::now() - start).count();
+    ControlStore final = store;
+
+    start = Clock::now();
+    bool rewound = journal.rewindTo(beforeOperations);
+    double undoUs = Micro(Clock::now() - start).count();
+    const ControlStore& current = store;
+    bool undone = current.size() == original.size() &&
+                  std::equal(current.ids(), current.ids() + current.size(), original.ids()) &&
+                  std::equal(current.states(), current.states() + current.size(), original.states());
+    start = Clock::now();
+    rewound = journal.rewindTo(afterOperations) && rewound;
+    double redoUs = Micro(Clock::now() - start).count();
+    bool redone = current.size() == final.size() &&
+                  std::equal(current.ids(), current.ids() + current.size(), final.ids()) &&
+                  std::equal(current.states(), current.states() + current.size(), final.states());
+
+    std::cout << operations << " journaled operations: " << recordUs << " us, journal " << journal.memoryUsage() / 1024
+              << " KiB against " << operations * original.memoryUsage() / 1024 << " KiB for a full backup before each; "
+              << "undo all " << undoUs << " us, redo all " << redoUs << " us"
+              << (rewound && undone && redone ? "" : " (MISMATCH)") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        runBenchmark();
+        return 0;
+    }
+
+    ControlStore controls({
+        {1, ControlType::Button, ControlState::Visible},
+        {2, ControlType::Button, ControlState::Invisible},
+        {3, ControlType::Slider, ControlState::Visible},
+        {4, ControlType::Slider, ControlState::Disabled},
+        {5, ControlType::Button, ControlState::Disabled},
+        {6, ControlType::Button, ControlState::Visible},
+        {7, ControlType::Slider, ControlState::Invisible},
+        {8, ControlType::Slider, ControlState::Disabled},
+        {9, ControlType::Button, ControlState::Invisible},
+        {10, ControlType::Slider, ControlState::Visible}
+    });
+    ControlStore backup = controls;
+    ControlJournal journal(controls);
+    ControlJournal::Checkpoint checkpoint = journal.checkpoint();
 
     int choice;
     while (true) {
@@ -122,34 +541,57 @@ int main() {
         std::cout << "6. Remove invisible controls\n";
         std::cout << "7. Reverse the control order\n";
         std::cout << "8. Partition visible controls\n";
+        std::cout << "9. Restore the backup\n";
+        std::cout << "10. Undo\n";
+        std::cout << "11. Redo\n";
+        std::cout << "12. Set a checkpoint\n";
+        std::cout << "13. Return to the checkpoint\n";
         std::cout << "0. Exit\n";
         std::cout << "Enter your choice: ";
-        std::cin >> choice;
+        if (!(std::cin >> choice)) {
+            return 0;
+        }
 
         switch (choice) {
             case 1:
-                createBackup(controls);
+                createBackup(controls, backup);
                 break;
             case 2:
-                disableAllControls(controls);
+                disableAllControls(journal);
                 break;
             case 3:
-                generateRandomStates(controls);
+                generateRandomStates(journal);
                 break;
             case 4:
-                transformSliders(controls);
+                transformSliders(journal);
                 break;
             case 5:
-                replaceDisabledWithEnabled(controls);
+                replaceDisabledWithEnabled(journal);
                 break;
             case 6:
-                removeInvisibleControls(controls);
+                removeInvisibleControls(journal);
                 break;
             case 7:
-                reverseControls(controls);
+                reverseControls(journal);
                 break;
             case 8:
-                partitionVisibleControls(controls);
+                partitionVisibleControls(journal);
+                break;
+            case 9:
+                restoreBackup(journal, backup);
+                break;
+            case 10:
+                undoOperation(journal);
+                break;
+            case 11:
+                redoOperation(journal);
+                break;
+            case 12:
+                checkpoint = journal.checkpoint();
+                std::cout << "\nCheckpoint set.\n";
+                break;
+            case 13:
+                returnToCheckpoint(journal, checkpoint);
                 break;
             case 0:
                 std::cout << "Exiting...\n";
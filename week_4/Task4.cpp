@@ -3,82 +3,329 @@
 #include <algorithm>
 #include <iterator>
 #include <set>
+#include <array>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include <limits>
+#include <initializer_list>
+#include "ControlStore.h"
 
-struct Control {
-    int id;           // Unique ID
-    std::string type; // "button" or "slider"
-    std::string state;// "visible", "invisible", or "disabled"
-    
-    bool operator<(const Control& other) const {
-        return id < other.id; // For sorting by ID
-    }
-};
+// Controls are ordered by ID
+bool operator<(const Control& a, const Control& b) {
+    return a.id < b.id;
+}
 
 // Function to print the list of controls
 void printControls(const std::vector<Control>& controls) {
     for (const auto& control : controls) {
-        std::cout << "ID: " << control.id << ", Type: " << control.type << ", State: " << control.state << std::endl;
+        std::cout << "ID: " << control.id << ", Type: " << toString(control.type) << ", State: " << toString(control.state) << std::endl;
     }
 }
 
-// Function to sort controls by ID using std::sort
-void sortControlsById(std::vector<Control>& controls) {
-    std::sort(controls.begin(), controls.end());
-    std::cout << "\nControls sorted by ID:\n";
+// Sorts controls by ID without moving them around while sorting: a least-significant-digit
+// radix sort orders (key, index) pairs packed in 64 bits, 11 bits of the key per pass, and the
+// controls are then gathered into their final order in one go. Passes where every key has the
+// same digit are skipped, so small ID ranges cost fewer passes. Each pass splits the pairs into
+// one chunk per thread: threads count their chunk's digits, the counts are turned into output
+// offsets in (digit, chunk) order, and threads scatter their chunks, which keeps the sort stable.
+// Buffers are kept between calls.
+class ControlSortEngine {
+    static constexpr unsigned kDigitBits = 11;   // Three passes cover a 32-bit key
+    static constexpr unsigned kPasses = (32 + kDigitBits - 1) / kDigitBits;
+    static constexpr size_t kBuckets = size_t(1) << kDigitBits;
+    static constexpr uint32_t kDigitMask = kBuckets - 1;
+    static constexpr size_t kMinChunk = size_t(1) << 16;   // Smaller inputs stay on one thread
+
+    using Histogram = std::array<size_t, kBuckets>;
+
+    unsigned threads;
+    std::vector<uint64_t> pairs;
+    std::vector<uint64_t> scratch;
+    std::vector<Control> sorted;
+    std::vector<Histogram> histograms;   // Per chunk
+
+    // Run f(chunk) for every chunk, chunk 0 on the calling thread
+    template <typename F>
+    static void forEachChunk(size_t chunks, F f) {
+        std::vector<std::thread> workers;
+        for (size_t chunk = 1; chunk < chunks; ++chunk) {
+            workers.emplace_back(f, chunk);
+        }
+        f(0);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+public:
+    explicit ControlSortEngine(unsigned threads = std::thread::hardware_concurrency())
+        : threads(std::max(1u, threads)) {}
+
+    unsigned threadCount() const { return threads; }
+
+    // Stable: controls with equal IDs keep their relative order
+    void sortById(std::vector<Control>& controls) {
+        const size_t n = controls.size();
+        if (n < 2) {
+            return;
+        }
+        if (n > UINT32_MAX) {
+            throw std::length_error("too many controls to sort");
+        }
+        const size_t chunks = std::max<size_t>(1, std::min<size_t>(threads, n / kMinChunk));
+        auto begin = [&](size_t chunk) { return n * chunk / chunks; };
+        pairs.resize(n);
+        scratch.resize(n);
+        histograms.assign(chunks, Histogram());
+
+        // Keys with the sign bit flipped sort as unsigned; remember which bits ever differ
+        std::vector<uint32_t> seen(chunks * 2);
+        forEachChunk(chunks, [&](size_t chunk) {
+            uint32_t all = ~uint32_t(0);
+            uint32_t any = 0;
+            for (size_t i = begin(chunk), end = begin(chunk + 1); i < end; ++i) {
+                uint32_t key = static_cast<uint32_t>(controls[i].id) ^ 0x80000000u;
+                pairs[i] = uint64_t(key) << 32 | i;
+                all &= key;
+                any |= key;
+            }
+            seen[chunk * 2] = all;
+            seen[chunk * 2 + 1] = any;
+        });
+        uint32_t all = ~uint32_t(0);
+        uint32_t any = 0;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            all &= seen[chunk * 2];
+            any |= seen[chunk * 2 + 1];
+        }
+
+        for (unsigned pass = 0; pass < kPasses; ++pass) {
+            const unsigned shift = 32 + kDigitBits * pass;
+            if (((all ^ any) >> (kDigitBits * pass) & kDigitMask) == 0) {
+                continue;  // Every key has the same digit here
+            }
+            forEachChunk(chunks, [&](size_t chunk) {
+                Histogram& counts = histograms[chunk];
+                counts.fill(0);
+                for (size_t i = begin(chunk), end = begin(chunk + 1); i < end; ++i) {
+                    counts[pairs[i] >> shift & kDigitMask]++;
+                }
+            });
+            size_t offset = 0;
+            for (size_t digit = 0; digit < kBuckets; ++digit) {
+                for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                    size_t count = histograms[chunk][digit];
+                    histograms[chunk][digit] = offset;
+                    offset += count;
+                }
+            }
+            forEachChunk(chunks, [&](size_t chunk) {
+                Histogram& next = histograms[chunk];
+                for (size_t i = begin(chunk), end = begin(chunk + 1); i < end; ++i) {
+                    scratch[next[pairs[i] >> shift & kDigitMask]++] = pairs[i];
+                }
+            });
+            pairs.swap(scratch);
+        }
+
+        // Apply the permutation once
+        sorted.resize(n);
+        forEachChunk(chunks, [&](size_t chunk) {
+            for (size_t i = begin(chunk), end = begin(chunk + 1); i < end; ++i) {
+                sorted[i] = controls[static_cast<uint32_t>(pairs[i])];
+            }
+        });
+        controls.swap(sorted);
+    }
+};
+
+// A sorted run of controls, e.g. the list of one ECU; the controls are not copied
+struct ControlSpan {
+    const Control* first;
+    const Control* last;
+
+    ControlSpan(const Control* first, const Control* last) : first(first), last(last) {}
+    ControlSpan(const std::vector<Control>& controls) : first(controls.data()), last(controls.data() + controls.size()) {}
+};
+
+// What to do with controls that share an ID across (or within) the merged runs
+enum class MergeConflict {
+    KeepAll,     // Keep every control, like std::merge
+    KeepFirst,   // Keep the one from the earliest run
+    KeepLast,    // Keep the one from the latest run
+    Combine      // Fold them together with a combine function
+};
+
+// Default combine rule: a control disabled by any source stays disabled, otherwise the later
+// source's state is used
+Control combineControls(const Control& earlier, const Control& later) {
+    if (earlier.state == ControlState::Disabled) {
+        return Control{later.id, later.type, ControlState::Disabled};
+    }
+    return later;
+}
+
+// Merges k sorted runs in O(n log k) with a loser tree: each internal node keeps the run that
+// lost the match played there, so after taking the winner's control only the matches on its
+// path to the root are replayed. Equal IDs come out in run order, then position order, which
+// makes the merge stable. Controls go straight to a sink (or a caller's buffer); the merger
+// only keeps the tree and run cursors, reused from one merge to the next.
+class ControlMerger {
+    std::vector<ControlSpan> runs;
+    std::vector<int64_t> keys;     // Per run: head ID in the high half, run index in the low half
+    std::vector<uint32_t> tree;    // tree[0]: winner, tree[1..k-1]: losers
+    uint32_t k = 0;
+
+    static constexpr int64_t kExhausted = std::numeric_limits<int64_t>::max();
+    static constexpr int64_t kSentinel = std::numeric_limits<int64_t>::min();   // Run k while building
+
+    // The run index in the key breaks ties between equal IDs, so a match is one comparison
+    void refreshKey(uint32_t run) {
+        const ControlSpan& span = runs[run];
+        keys[run] = span.first == span.last ? kExhausted : int64_t(span.first->id) * (int64_t(1) << 32) + run;
+    }
+
+    static int idOf(int64_t key) { return static_cast<int>(key >> 32); }
+
+    // Play the run's way up from its leaf to the root
+    void replay(uint32_t run) {
+        int64_t runKey = keys[run];
+        for (uint32_t node = (run + k) / 2; node > 0; node /= 2) {
+            int64_t otherKey = keys[tree[node]];
+            if (otherKey < runKey) {
+                std::swap(tree[node], run);
+                runKey = otherKey;
+            }
+        }
+        tree[0] = run;
+    }
+
+    void build(const ControlSpan* sources, size_t count) {
+        if (count >= (size_t(1) << 31)) {
+            throw std::length_error("too many runs to merge");
+        }
+        runs.assign(sources, sources + count);
+        k = static_cast<uint32_t>(count);
+        keys.resize(k + 1);
+        for (uint32_t run = 0; run < k; ++run) {
+            refreshKey(run);
+        }
+        keys[k] = kSentinel;
+        tree.assign(std::max<size_t>(k, 1), k);   // Every node starts with the sentinel run
+        for (uint32_t run = k; run-- > 0;) {
+            replay(run);
+        }
+    }
+
+    // Take the winner's head control and replay its run
+    const Control& pop() {
+        uint32_t run = tree[0];
+        const Control& control = *runs[run].first++;
+        refreshKey(run);
+        replay(run);
+        return control;
+    }
+
+public:
+    // Merge into sink(const Control&); returns the number of controls produced
+    template <typename Sink, typename Combine = Control (*)(const Control&, const Control&)>
+    size_t merge(const ControlSpan* sources, size_t count, Sink sink, MergeConflict policy = MergeConflict::KeepAll,
+                 Combine combine = combineControls) {
+        if (count == 0) {
+            return 0;
+        }
+        build(sources, count);
+        size_t produced = 0;
+        while (keys[tree[0]] != kExhausted) {
+            Control current = pop();
+            if (policy != MergeConflict::KeepAll) {
+                while (keys[tree[0]] != kExhausted && idOf(keys[tree[0]]) == current.id) {
+                    const Control& next = pop();
+                    if (policy == MergeConflict::KeepLast) {
+                        current = next;
+                    } else if (policy == MergeConflict::Combine) {
+                        current = combine(current, next);
+                    }
+                }
+            }
+            sink(current);
+            produced++;
+        }
+        return produced;
+    }
+
+    template <typename Sink, typename... Options>
+    size_t merge(std::initializer_list<ControlSpan> sources, Sink sink, Options... options) {
+        return merge(sources.begin(), sources.size(), sink, options...);
+    }
+
+    // Merge into a caller's buffer, which must have room for every control of every run
+    template <typename... Options>
+    size_t mergeInto(std::initializer_list<ControlSpan> sources, Control* output, Options... options) {
+        return merge(sources.begin(), sources.size(), [&](const Control& control) { *output++ = control; }, options...);
+    }
+
+    template <typename... Options>
+    size_t mergeInto(const ControlSpan* sources, size_t count, Control* output, Options... options) {
+        return merge(sources, count, [&](const Control& control) { *output++ = control; }, options...);
+    }
+};
+
+// Function to sort controls by ID with the radix sort engine
+void sortControlsById(ControlSortEngine& engine, std::vector<Control>& controls) {
+    engine.sortById(controls);
+    std::cout << "\nControls sorted by ID (radix sort, up to " << engine.threadCount() << " threads):\n";
     printControls(controls);
 }
 
-// Function to use std::stable_sort to maintain relative order of controls with equal IDs
-void stableSortControlsById(std::vector<Control>& controls) {
-    std::stable_sort(controls.begin(), controls.end());
-    std::cout << "\nControls sorted by ID using stable_sort (maintaining relative order for equal IDs):\n";
+// Function to sort controls by ID while maintaining the relative order of controls with equal IDs
+// (the radix sort is stable; shown on both lists together, which share some IDs)
+void stableSortControlsById(ControlSortEngine& engine, std::vector<Control>& controls) {
+    engine.sortById(controls);
+    std::cout << "\nControls sorted by ID with a stable sort (maintaining relative order for equal IDs):\n";
     printControls(controls);
 }
 
 // Function to perform binary search for a control by ID using std::lower_bound and std::upper_bound
 void binarySearchById(const std::vector<Control>& controls, int id) {
-    auto lower = std::lower_bound(controls.begin(), controls.end(), Control{id, "", ""});
-    auto upper = std::upper_bound(controls.begin(), controls.end(), Control{id, "", ""});
+    auto lower = std::lower_bound(controls.begin(), controls.end(), Control{id, ControlType::Button, ControlState::Visible});
+    auto upper = std::upper_bound(controls.begin(), controls.end(), Control{id, ControlType::Button, ControlState::Visible});
     
     if (lower != controls.end() && lower->id == id) {
-        std::cout << "\nFound control with ID " << id << " using lower_bound: Type = " << lower->type << ", State = " << lower->state << std::endl;
+        std::cout << "\nFound control with ID " << id << " using lower_bound: Type = " << toString(lower->type) << ", State = " << toString(lower->state) << std::endl;
     } else {
         std::cout << "\nControl with ID " << id << " not found using lower_bound." << std::endl;
     }
     
     if (upper != controls.end() && upper != lower) {
-        std::cout << "Found control with ID " << id << " using upper_bound: Type = " << upper->type << ", State = " << upper->state << std::endl;
+        std::cout << "Found control with ID " << id << " using upper_bound: Type = " << toString(upper->type) << ", State = " << toString(upper->state) << std::endl;
     } else {
         std::cout << "Control with ID " << id << " not found using upper_bound." << std::endl;
     }
 }
 
-// Function to merge two sorted lists of controls
-void mergeControlLists(std::vector<Control>& list1, std::vector<Control>& list2) {
-    std::vector<Control> merged(list1.size() + list2.size());
-    std::merge(list1.begin(), list1.end(), list2.begin(), list2.end(), merged.begin());
-    
+// Function to merge two sorted lists of controls, streaming the result straight to the output
+void mergeControlLists(ControlMerger& merger, const std::vector<Control>& list1, const std::vector<Control>& list2) {
     std::cout << "\nMerged control lists:\n";
-    printControls(merged);
+    merger.merge({list1, list2}, [](const Control& control) {
+        std::cout << "ID: " << control.id << ", Type: " << toString(control.type) << ", State: " << toString(control.state) << std::endl;
+    });
 }
 
-// Function to perform std::inplace_merge to combine two different segments in the same list
-void inplaceMergeControls(std::vector<Control>& controls1, std::vector<Control>& controls2) {
-    // Merge both lists into a combined vector
-    std::vector<Control> combined;
-    combined.reserve(controls1.size() + controls2.size());
-    combined.insert(combined.end(), controls1.begin(), controls1.end());
-    combined.insert(combined.end(), controls2.begin(), controls2.end());
+// Function to merge two sorted lists into one buffer, keeping one control per ID
+void mergeControlsWithPolicy(ControlMerger& merger, const std::vector<Control>& controls1, const std::vector<Control>& controls2,
+                             MergeConflict policy) {
+    std::vector<Control> merged(controls1.size() + controls2.size());
+    merged.resize(merger.mergeInto({controls1, controls2}, merged.data(), policy));
 
-    // Sort the combined list first to ensure the merging happens correctly
-    std::sort(combined.begin(), combined.end());
-
-    // Now, use inplace_merge to combine the first half and second half in the sorted list
-    std::inplace_merge(combined.begin(), combined.begin() + controls1.size(), combined.end());
-
-    // Print the result after the inplace merge
-    std::cout << "\nIn-place merged controls from both lists:\n";
-    printControls(combined);
+    const char* policyNames[] = {"keeping every control", "keeping the first control", "keeping the last control",
+                                 "combining the controls"};
+    std::cout << "\nMerged controls from both lists, " << policyNames[static_cast<int>(policy)] << " for each ID:\n";
+    printControls(merged);
 }
 
 // Function to perform set operations: union and intersection
@@ -104,31 +351,153 @@ void setOperations(const std::vector<Control>& list1, const std::vector<Control>
     printControls(intersectionResult);
 }
 
-int main() {
+// Sorting 1M-10M controls with random, partly duplicate IDs: std::sort, std::stable_sort and the
+// radix sort engine on one thread and on every hardware thread. The engine's output must match
+// std::stable_sort exactly, equal IDs included.
+void benchmarkSort() {
+    using Clock = std::chrono::steady_clock;
+    using Milli = std::chrono::duration<double, std::milli>;
+    std::mt19937 gen(42);
+
+    for (size_t count : {size_t(1000000), size_t(4000000), size_t(10000000)}) {
+        std::vector<Control> input(count);
+        for (size_t i = 0; i < count; ++i) {
+            input[i] = {static_cast<int>(gen() % count), static_cast<ControlType>(gen() % 2), static_cast<ControlState>(gen() % 4)};
+        }
+
+        std::vector<Control> reference = input;
+        auto start = Clock::now();
+        std::sort(reference.begin(), reference.end());
+        double sortMs = Milli(Clock::now() - start).count();
+
+        reference = input;
+        start = Clock::now();
+        std::stable_sort(reference.begin(), reference.end());
+        double stableMs = Milli(Clock::now() - start).count();
+
+        std::cout << count << " controls: std::sort " << sortMs << " ms, std::stable_sort " << stableMs << " ms";
+        unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned threads : {1u, hardware}) {
+            ControlSortEngine engine(threads);
+            std::vector<Control> controls = input;
+            engine.sortById(controls);  // Warm up: the engine keeps its buffers between sorts
+            controls = input;
+            start = Clock::now();
+            engine.sortById(controls);
+            double radixMs = Milli(Clock::now() - start).count();
+            bool same = std::equal(controls.begin(), controls.end(), reference.begin(), [](const Control& a, const Control& b) {
+                return a.id == b.id && a.type == b.type && a.state == b.state;
+            });
+            std::cout << ", radix sort (" << threads << (threads == 1 ? " thread) " : " threads) ") << radixMs << " ms"
+                      << (same ? "" : " (MISMATCH)");
+            if (hardware == 1) {
+                break;
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Merging k sorted lists with 4M controls in total: the previous approach (concatenate and sort,
+// as inplaceMergeControls did), pairwise std::merge into new vectors, and the loser tree into
+// one preallocated buffer, keeping all controls and keeping the first per ID
+void benchmarkMerge() {
+    using Clock = std::chrono::steady_clock;
+    using Milli = std::chrono::duration<double, std::milli>;
+    const size_t total = 4000000;
+    std::mt19937 gen(7);
+    auto same = [](const std::vector<Control>& a, const std::vector<Control>& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const Control& x, const Control& y) {
+            return x.id == y.id && x.type == y.type && x.state == y.state;
+        });
+    };
+
+    for (size_t k : {size_t(2), size_t(8), size_t(64)}) {
+        std::vector<std::vector<Control>> lists(k);
+        for (std::vector<Control>& list : lists) {
+            for (size_t i = 0; i < total / k; ++i) {
+                list.push_back({static_cast<int>(gen() % total), static_cast<ControlType>(gen() % 2), static_cast<ControlState>(gen() % 4)});
+            }
+            std::stable_sort(list.begin(), list.end());
+        }
+
+        auto start = Clock::now();
+        std::vector<Control> sorted;
+        for (const std::vector<Control>& list : lists) {
+            sorted.insert(sorted.end(), list.begin(), list.end());
+        }
+        std::stable_sort(sorted.begin(), sorted.end());
+        double sortMs = Milli(Clock::now() - start).count();
+
+        start = Clock::now();
+        std::vector<Control> cascaded = lists[0];
+        for (size_t i = 1; i < k; ++i) {
+            std::vector<Control> next(cascaded.size() + lists[i].size());
+            std::merge(cascaded.begin(), cascaded.end(), lists[i].begin(), lists[i].end(), next.begin());
+            cascaded.swap(next);
+        }
+        double cascadeMs = Milli(Clock::now() - start).count();
+
+        std::vector<ControlSpan> sources(lists.begin(), lists.end());
+        std::vector<Control> buffer(total);
+        ControlMerger merger;
+        start = Clock::now();
+        size_t produced = merger.mergeInto(sources.data(), sources.size(), buffer.data());
+        double treeMs = Milli(Clock::now() - start).count();
+        std::vector<Control> merged(buffer.begin(), buffer.begin() + produced);
+
+        start = Clock::now();
+        produced = merger.mergeInto(sources.data(), sources.size(), buffer.data(), MergeConflict::KeepFirst);
+        double firstMs = Milli(Clock::now() - start).count();
+        std::vector<Control> firsts(buffer.begin(), buffer.begin() + produced);
+        sorted.erase(std::unique(sorted.begin(), sorted.end(), [](const Control& a, const Control& b) { return a.id == b.id; }),
+                     sorted.end());
+
+        std::cout << "Merging " << k << " lists of " << total / k << " controls: concatenate + stable_sort " << sortMs
+                  << " ms, pairwise std::merge " << cascadeMs << " ms, loser tree " << treeMs << " ms (keep first "
+                  << firstMs << " ms, " << firsts.size() << " IDs)"
+                  << (same(merged, cascaded) && same(firsts, sorted) ? "" : " (MISMATCH)") << std::endl;
+    }
+}
+
+void runBenchmark() {
+    benchmarkSort();
+    benchmarkMerge();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        runBenchmark();
+        return 0;
+    }
+
     std::vector<Control> controls1 = {
-        {1, "button", "visible"},
-        {2, "slider", "invisible"},
-        {3, "button", "disabled"},
-        {5, "slider", "visible"},
-        {7, "button", "disabled"}
+        {1, ControlType::Button, ControlState::Visible},
+        {2, ControlType::Slider, ControlState::Invisible},
+        {3, ControlType::Button, ControlState::Disabled},
+        {5, ControlType::Slider, ControlState::Visible},
+        {7, ControlType::Button, ControlState::Disabled}
     };
 
     std::vector<Control> controls2 = {
-        {2, "slider", "visible"},
-        {3, "button", "invisible"},
-        {4, "slider", "disabled"},
-        {6, "button", "visible"},
-        {7, "slider", "disabled"}
+        {2, ControlType::Slider, ControlState::Visible},
+        {3, ControlType::Button, ControlState::Invisible},
+        {4, ControlType::Slider, ControlState::Disabled},
+        {6, ControlType::Button, ControlState::Visible},
+        {7, ControlType::Slider, ControlState::Disabled}
     };
 
+    ControlSortEngine engine;
+    ControlMerger merger;
+
     int choice;
     while (true) {
         std::cout << "\nChoose an operation:\n";
-        std::cout << "1. Sort controls by ID using std::sort\n";
-        std::cout << "2. Sort controls by ID using std::stable_sort\n";
+        std::cout << "1. Sort controls by ID (parallel radix sort)\n";
+        std::cout << "2. Stable sort both control lists together by ID\n";
         std::cout << "3. Perform binary search by ID (using std::lower_bound and std::upper_bound)\n";
         std::cout << "4. Merge two sorted control lists\n";
-        std::cout << "5. In-place merge two segments of the control list\n";
+        std::cout << "5. Merge two sorted control lists with one control per ID (keep first, keep last or combine)\n";
         std::cout << "6. Perform set operations (union and intersection) between two lists\n";
         std::cout << "0. Exit\n";
         std::cout << "Enter your choice: ";
@@ -137,12 +506,13 @@ int main() {
         switch (choice) {
             case 1: {
                 std::vector<Control> tempControls = controls1;  // To not modify the original
-                sortControlsById(tempControls);
+                sortControlsById(engine, tempControls);
                 break;
             }
             case 2: {
                 std::vector<Control> tempControls = controls1;
-                stableSortControlsById(tempControls);
+                tempControls.insert(tempControls.end(), controls2.begin(), controls2.end());
+                stableSortControlsById(engine, tempControls);
                 break;
             }
             case 3: {
@@ -153,13 +523,17 @@ int main() {
                 break;
             }
             case 4: {
-                std::vector<Control> tempControls1 = controls1;
-                std::vector<Control> tempControls2 = controls2;
-                mergeControlLists(tempControls1, tempControls2);
+                mergeControlLists(merger, controls1, controls2);
                 break;
             }
             case 5: {
-                inplaceMergeControls(controls1, controls2); // Updated for two separate lists
+                int policy;
+                std::cout << "Duplicate IDs: 1. Keep first, 2. Keep last, 3. Combine (disabled wins): ";
+                if (std::cin >> policy && policy >= 1 && policy <= 3) {
+                    mergeControlsWithPolicy(merger, controls1, controls2, static_cast<MergeConflict>(policy));
+                } else {
+                    std::cout << "Invalid policy.\n";
+                }
                 break;
             }
             case 6: {